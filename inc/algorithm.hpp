@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// How the walls of a maze came about, `Imported` walls were drawn elsewhere and have no seed. The values are stored in
+// maze files, new algorithms are only ever appended.
+enum class Algorithm : uint8_t {
+    Backtracker,
+    Imported,
+    BinaryTree,
+    Sidewinder,
+    RecursiveDivision,
+    GrowingTreeNewest,
+    GrowingTreeRandom,
+    GrowingTreeOldest,
+    GrowingTreeMixed,
+    HuntAndKill,
+    Prim,
+    AldousBroder,
+    Wilson,
+};
+
+// Readers of maze files refuse values beyond the last algorithm.
+constexpr static auto LAST_ALGORITHM{Algorithm::Wilson};
+
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// One bit per cell, rows padded to whole 64 bit words so row operations never straddle two rows. Padding bits are
+// always zero. The words are either owned or a read only view of external memory such as a mapped file.
+class BitPlane {
+  public:
+    constexpr static std::size_t WORD_BITS{64};
+
+    BitPlane() = default;
+
+    BitPlane(std::size_t cols, std::size_t rows, bool value) :
+        m_cols(cols), m_rows(rows), m_words_per_row(words_per_row(cols)), m_words(m_words_per_row * rows, 0) {
+        if (value) {
+            for (std::size_t row = 0; row < rows; ++row) {
+                std::fill_n(row_words(row), m_words_per_row, ~uint64_t(0));
+                row_words(row)[m_words_per_row - 1] &= tail_mask();
+            }
+        }
+    }
+
+    // Makes this a plane of `cols` x `rows` with every bit `value`, in the words it owns already as far as they go.
+    void reshape(std::size_t cols, std::size_t rows, bool value) {
+        m_cols = cols;
+        m_rows = rows;
+        m_words_per_row = words_per_row(cols);
+        m_view = nullptr;
+        m_words.assign(m_words_per_row * rows, (value) ? ~uint64_t(0) : 0);
+        if (value) {
+            for (std::size_t row = 0; row < rows; ++row) {
+                row_words(row)[m_words_per_row - 1] &= tail_mask();
+            }
+        }
+    }
+
+    static BitPlane view(std::size_t cols, std::size_t rows, const uint64_t* words) {
+        BitPlane plane;
+        plane.m_cols = cols;
+        plane.m_rows = rows;
+        plane.m_words_per_row = words_per_row(cols);
+        plane.m_view = words;
+        return plane;
+    }
+
+    static constexpr std::size_t words_per_row(std::size_t cols) {
+        return (cols + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    std::size_t cols() const {
+        return m_cols;
+    }
+
+    std::size_t rows() const {
+        return m_rows;
+    }
+
+    std::size_t words_per_row() const {
+        return m_words_per_row;
+    }
+
+    std::size_t word_count() const {
+        return m_words_per_row * m_rows;
+    }
+
+    bool empty() const {
+        return m_rows == 0;
+    }
+
+    bool is_view() const {
+        return m_view != nullptr;
+    }
+
+    // Valid bits of the last word of every row.
+    uint64_t tail_mask() const {
+        auto used{m_cols % WORD_BITS};
+        return (used == 0) ? ~uint64_t(0) : (uint64_t(1) << used) - 1;
+    }
+
+    bool test(std::size_t col, std::size_t row) const {
+        return (row_words(row)[col / WORD_BITS] >> (col % WORD_BITS)) & 1;
+    }
+
+    void set(std::size_t col, std::size_t row) {
+        row_words(row)[col / WORD_BITS] |= uint64_t(1) << (col % WORD_BITS);
+    }
+
+    void reset(std::size_t col, std::size_t row) {
+        row_words(row)[col / WORD_BITS] &= ~(uint64_t(1) << (col % WORD_BITS));
+    }
+
+    std::size_t count() const {
+        std::size_t bits{0};
+        for (std::size_t word = 0; word < word_count(); ++word) {
+            bits += static_cast<std::size_t>(std::popcount(data()[word]));
+        }
+        return bits;
+    }
+
+    // Cell index `row * cols + col` of the `n`-th set bit in row major order, there have to be more than `n` set bits.
+    std::size_t nth_set(std::size_t n) const {
+        for (std::size_t word = 0;; ++word) {
+            auto bits{data()[word]};
+            auto count{static_cast<std::size_t>(std::popcount(bits))};
+            if (n < count) {
+                for (; n > 0; --n) {
+                    bits &= bits - 1;
+                }
+                auto col{(word % m_words_per_row) * WORD_BITS + static_cast<std::size_t>(std::countr_zero(bits))};
+                return (word / m_words_per_row) * m_cols + col;
+            }
+            n -= count;
+        }
+    }
+
+    const uint64_t* data() const {
+        return (m_view) ? m_view : m_words.data();
+    }
+
+    uint64_t* data() {
+        assert(!is_view());
+        return m_words.data();
+    }
+
+    const uint64_t* row_words(std::size_t row) const {
+        return data() + row * m_words_per_row;
+    }
+
+    uint64_t* row_words(std::size_t row) {
+        return data() + row * m_words_per_row;
+    }
+
+  private:
+    std::size_t m_cols{0};
+    std::size_t m_rows{0};
+    std::size_t m_words_per_row{0};
+    std::vector<uint64_t> m_words;
+    const uint64_t* m_view{nullptr};
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Monotone priority queue of cells for small integer keys. Pushed keys may never be below the key last popped nor more
+// than `span` above it, which holds for Dijkstra and for A* with a consistent heuristic as long as `span` covers the
+// largest step cost. Every key has its own bucket in a ring of at least `span + 1` buckets, so push and pop cost no
+// comparisons, only pop skips over the empty buckets in between.
+//
+// The buckets are circular lists threaded through two links per cell, each bucket's list closed by a link of its own
+// after those of the cells. A cell is in at most one bucket, pushing a queued cell again moves it to its new key, and
+// the links are sized once per `reset`, so no push ever allocates.
+class BucketQueue {
+  public:
+    explicit BucketQueue(uint32_t span) {
+        reset(span, 0);
+    }
+
+    BucketQueue() : BucketQueue(0) {
+    }
+
+    // Empties the queue for keys up to `span` apart and cells below `cells`, the links keep their memory.
+    void reset(uint32_t span, std::size_t cells) {
+        m_cells = cells;
+        m_buckets = std::bit_ceil(span + 1);
+        m_mask = m_buckets - 1;
+        if (m_next.size() < cells + m_buckets) {
+            m_next.resize(cells + m_buckets);
+            m_previous.resize(cells + m_buckets);
+        }
+        std::fill_n(m_next.begin(), cells, NOT_QUEUED);
+        for (auto bucket{cells}; bucket < cells + m_buckets; ++bucket) {
+            m_next[bucket] = bucket;
+            m_previous[bucket] = bucket;
+        }
+        m_current = 0;
+        m_size = 0;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    void push(int32_t key, std::size_t cell) {
+        if (m_next[cell] != NOT_QUEUED) {
+            unlink(cell);
+        }
+        if (m_size == 0 || key < m_current) {
+            m_current = key;
+        }
+        auto bucket{m_cells + (static_cast<uint32_t>(key) & m_mask)};
+        m_next[cell] = m_next[bucket];
+        m_previous[cell] = bucket;
+        m_previous[m_next[bucket]] = cell;
+        m_next[bucket] = cell;
+        ++m_size;
+    }
+
+    // Removes a cell of the lowest key, the queue must not be empty. Cells of equal keys come last in first out.
+    std::pair<int32_t, std::size_t> pop() {
+        auto bucket{m_cells + (static_cast<uint32_t>(m_current) & m_mask)};
+        while (m_next[bucket] == bucket) {
+            ++m_current;
+            bucket = m_cells + (static_cast<uint32_t>(m_current) & m_mask);
+        }
+        auto cell{m_next[bucket]};
+        unlink(cell);
+        m_next[cell] = NOT_QUEUED;
+        return {m_current, cell};
+    }
+
+    std::size_t memory_usage() const {
+        return (m_next.capacity() + m_previous.capacity()) * sizeof(std::size_t);
+    }
+
+  private:
+    constexpr static auto NOT_QUEUED{std::numeric_limits<std::size_t>::max()};
+
+    void unlink(std::size_t cell) {
+        m_next[m_previous[cell]] = m_next[cell];
+        m_previous[m_next[cell]] = m_previous[cell];
+        --m_size;
+    }
+
+    // the links of the cells followed by those closing the buckets
+    std::vector<std::size_t> m_next;
+    std::vector<std::size_t> m_previous;
+    std::size_t m_cells{0};
+    uint32_t m_buckets{1};
+    uint32_t m_mask{0};
+    int32_t m_current{0};
+    std::size_t m_size{0};
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+// Half-open range of cells [first, last) that intersect the screen.
+struct CellRange {
+    int32_t first_col;
+    int32_t first_row;
+    int32_t last_col;
+    int32_t last_row;
+};
+
+// Maps maze cells to screen pixels.
+// A zoom level >= 1 draws every cell with its walls at `zoom` screen pixels per maze pixel. A zoom level <= 0 is the
+// overview (level of detail) mode where every screen pixel shows a single cell, skipping 2^-zoom - 1 cells in between.
+class Camera {
+  public:
+    constexpr static auto MIN_ZOOM{-8};
+    constexpr static auto MAX_ZOOM{8};
+
+    Camera(int32_t cell_pitch_w, int32_t cell_pitch_h, int32_t screen_w, int32_t screen_h) :
+        m_pitch_w(cell_pitch_w), m_pitch_h(cell_pitch_h), m_screen_w(screen_w), m_screen_h(screen_h) {};
+
+    // Picks the largest zoom level at which the whole maze fits on the screen.
+    void fit(int32_t cols, int32_t rows) {
+        m_col = 0.0F;
+        m_row = 0.0F;
+        m_zoom = MAX_ZOOM;
+        while (m_zoom > MIN_ZOOM &&
+               (visible_cols() < static_cast<float>(cols) || visible_rows() < static_cast<float>(rows))) {
+            --m_zoom;
+        }
+    }
+
+    // Moves the camera by the given amount of screen pixels.
+    void pan(float dx, float dy) {
+        m_col += dx / pixels_per_col();
+        m_row += dy / pixels_per_row();
+    }
+
+    // Zooms in (positive steps) or out (negative steps) keeping the cell below the screen position (x, y) in place.
+    void zoom(int32_t steps, int32_t x, int32_t y) {
+        auto anchor_col{m_col + static_cast<float>(x) / pixels_per_col()};
+        auto anchor_row{m_row + static_cast<float>(y) / pixels_per_row()};
+        m_zoom = std::clamp(m_zoom + steps, MIN_ZOOM, MAX_ZOOM);
+        m_col = anchor_col - static_cast<float>(x) / pixels_per_col();
+        m_row = anchor_row - static_cast<float>(y) / pixels_per_row();
+    }
+
+    bool is_overview() const {
+        return m_zoom <= 0;
+    }
+
+    // Screen pixels per maze pixel, only meaningful outside of the overview mode.
+    int32_t scale() const {
+        return std::max(m_zoom, 1);
+    }
+
+    CellRange visible_cells(int32_t cols, int32_t rows) const {
+        return {std::clamp(static_cast<int32_t>(std::floor(m_col)), 0, cols),
+                std::clamp(static_cast<int32_t>(std::floor(m_row)), 0, rows),
+                std::clamp(static_cast<int32_t>(std::floor(m_col + visible_cols())) + 1, 0, cols),
+                std::clamp(static_cast<int32_t>(std::floor(m_row + visible_rows())) + 1, 0, rows)};
+    }
+
+    // Top left screen pixel of a cell.
+    std::pair<int32_t, int32_t> to_screen(int32_t col, int32_t row) const {
+        return {static_cast<int32_t>(std::floor((static_cast<float>(col) - m_col) * pixels_per_col())),
+                static_cast<int32_t>(std::floor((static_cast<float>(row) - m_row) * pixels_per_row()))};
+    }
+
+    // Screen pixel in the middle of a cell (without its walls).
+    std::pair<int32_t, int32_t> to_screen_center(int32_t col, int32_t row, int32_t cell_w, int32_t cell_h) const {
+        auto [x, y] = to_screen(col, row);
+        if (is_overview()) {
+            return {x, y};
+        }
+        return {x + cell_w * scale() / 2, y + cell_h * scale() / 2};
+    }
+
+    // Cell column/row shown at a screen pixel, may be outside of the maze.
+    int32_t col_at(int32_t x) const {
+        return static_cast<int32_t>(std::floor(m_col + static_cast<float>(x) / pixels_per_col()));
+    }
+
+    int32_t row_at(int32_t y) const {
+        return static_cast<int32_t>(std::floor(m_row + static_cast<float>(y) / pixels_per_row()));
+    }
+
+  private:
+    float pixels_per_col() const {
+        if (is_overview()) {
+            return 1.0F / static_cast<float>(1 << -m_zoom);
+        }
+        return static_cast<float>(m_pitch_w * m_zoom);
+    }
+
+    float pixels_per_row() const {
+        if (is_overview()) {
+            return 1.0F / static_cast<float>(1 << -m_zoom);
+        }
+        return static_cast<float>(m_pitch_h * m_zoom);
+    }
+
+    float visible_cols() const {
+        return static_cast<float>(m_screen_w) / pixels_per_col();
+    }
+
+    float visible_rows() const {
+        return static_cast<float>(m_screen_h) / pixels_per_row();
+    }
+
+  private:
+    int32_t m_pitch_w;
+    int32_t m_pitch_h;
+    int32_t m_screen_w;
+    int32_t m_screen_h;
+
+    float m_col{0.0F};
+    float m_row{0.0F};
+    int32_t m_zoom{1};
+};
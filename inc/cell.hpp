@@ -1,10 +1,13 @@
+#pragma once
+
 #include "olcPixelGameEngine.h"
 
+#include "camera.hpp"
+#include "direction.hpp"
 #include <bitset>
 #include <cstdint>
-#include <vector>
-
-enum class Direction : uint8_t { North, East, South, West, NUM };
+#include <limits>
+#include <utility>
 
 class Cell {
     constexpr static auto WALL_WIDTH{1};
@@ -12,21 +15,37 @@ class Cell {
   public:
     Cell(int32_t x, int32_t y, int32_t w, int32_t h) : m_x(x), m_y(y), m_w(w), m_h(h) {};
 
-    void draw(olc::PixelGameEngine* pge, olc::Pixel color = olc::WHITE) {
+    void draw(olc::PixelGameEngine* pge, const Camera& camera, olc::Pixel color = olc::WHITE) const {
+        auto [x, y] = camera.to_screen(m_x, m_y);
+        if (camera.is_overview()) {
+            pge->Draw(x, y, overview_color(color));
+            return;
+        }
+        auto scale{camera.scale()};
         if (!m_walls.test(std::to_underlying(Direction::East))) {
-            pge->FillRect(m_x * (m_w + WALL_WIDTH) + m_w, m_y * (m_h + WALL_WIDTH), WALL_WIDTH, m_h, color);
+            pge->FillRect(x + m_w * scale, y, WALL_WIDTH * scale, m_h * scale, color);
         }
         if (!m_walls.test(std::to_underlying(Direction::South))) {
-            pge->FillRect(m_x * (m_w + WALL_WIDTH), m_y * (m_h + WALL_WIDTH) + m_h, m_w, WALL_WIDTH, color);
+            pge->FillRect(x, y + m_h * scale, m_w * scale, WALL_WIDTH * scale, color);
+        }
+        pge->FillRect(x, y, m_w * scale, m_h * scale, (m_visited) ? color : olc::BLUE);
+    }
+
+    // Single pixel representation for the overview, cells with more walls are drawn darker.
+    olc::Pixel overview_color(olc::Pixel color = olc::WHITE) const {
+        if (!m_visited) {
+            return olc::BLUE;
         }
-        pge->FillRect(m_x * (m_w + WALL_WIDTH), m_y * (m_h + WALL_WIDTH), m_w, m_h, (m_visited) ? color : olc::BLUE);
+        auto open_walls{static_cast<uint32_t>(m_walls.size() - m_walls.count() + 1)};
+        auto shade = [&](uint8_t channel) { return static_cast<uint8_t>(channel * open_walls / (m_walls.size() + 1)); };
+        return {shade(color.r), shade(color.g), shade(color.b)};
     }
 
     void remove_wall(Direction wall) {
         m_walls.set(std::to_underlying(wall), false);
     }
 
-    bool has_wall(Direction wall) {
+    bool has_wall(Direction wall) const {
         return m_walls.test(std::to_underlying(wall));
     }
 
@@ -34,7 +53,7 @@ class Cell {
         m_visited = true;
     }
 
-    bool is_visited() {
+    bool is_visited() const {
         return m_visited;
     }
 
@@ -43,8 +62,8 @@ class Cell {
     int32_t m_w;
     int32_t m_h;
     int32_t m_g_score{std::numeric_limits<int32_t>::max()};
-    double m_f_score{std::numeric_limits<double>::max()};
 
     bool m_visited{false};
-    std::bitset<std::to_underlying(Direction::NUM)> m_walls{std::bitset<4>().set()};
+    // north, east, south and west, cells have no walls towards other layers
+    std::bitset<4> m_walls{std::bitset<4>().set()};
 };
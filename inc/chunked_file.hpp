@@ -0,0 +1,301 @@
+#pragma once
+
+#include "maze.hpp"
+#include "range_coder.hpp"
+#include "wall_grid.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Tiled maze file: the wall grid is split into square chunks which are compressed independently, followed by an index
+// with the offset and size of every chunk. Readers only decompress the chunks overlapping the region they need.
+//
+// Each cell is coded as its east and south wall bit with an adaptive range coder. The contexts are the already coded
+// walls around the cell: a perfect maze has no isolated cells and no loops, which makes many bits predictable. Cells
+// outside the chunk count as closed so every chunk decodes on its own.
+namespace chunked_file {
+constexpr static std::array<char, 4> MAGIC{'M', 'Z', 'C', 'K'};
+constexpr static uint16_t VERSION{1};
+constexpr static uint32_t CHUNK_SIZE{256};
+
+static_assert(std::endian::native == std::endian::little, "chunked files are read without byte swapping");
+
+struct Header {
+    std::array<char, 4> magic;
+    uint16_t version;
+    uint8_t algorithm;
+    uint8_t wrap;
+    uint32_t cols;
+    uint32_t rows;
+    uint32_t chunk_size;
+    uint32_t chunks_x;
+    uint32_t chunks_y;
+    uint32_t reserved2;
+    uint64_t seed;
+    uint64_t index_offset;
+};
+static_assert(sizeof(Header) == 48);
+
+struct ChunkEntry {
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Probabilities of the wall bits, indexed by the context of the already coded walls around the cell.
+struct Contexts {
+    Contexts() {
+        east.fill(range_coder::PROBABILITY_INIT);
+        south.fill(range_coder::PROBABILITY_INIT);
+    }
+
+    std::array<range_coder::Probability, 16> east;
+    std::array<range_coder::Probability, 16> south;
+};
+
+// Open sides of the cells coded so far in the current and the previous row of a chunk.
+class Neighbourhood {
+  public:
+    explicit Neighbourhood(std::size_t cols) : m_north_open(cols + 1, 0), m_north_east_open(cols, 0) {};
+
+    void start_row() {
+        m_west_open = false;
+        m_south_west_open = false;
+    }
+
+    // West and north side of the cell, and the two walls of the north east corner: with all four open a passage east
+    // would close a loop, which a perfect maze never has.
+    std::size_t east_context(std::size_t col) const {
+        return (static_cast<std::size_t>(m_west_open) << 3) | (static_cast<std::size_t>(m_north_open[col]) << 2) |
+               (static_cast<std::size_t>(m_north_east_open[col]) << 1) |
+               static_cast<std::size_t>(m_north_open[col + 1]);
+    }
+
+    std::size_t south_context(std::size_t col, bool east) const {
+        return (static_cast<std::size_t>(m_west_open) << 3) | (static_cast<std::size_t>(m_north_open[col]) << 2) |
+               (static_cast<std::size_t>(!east) << 1) | static_cast<std::size_t>(m_south_west_open);
+    }
+
+    void update(std::size_t col, bool east, bool south) {
+        m_west_open = !east;
+        m_south_west_open = !south;
+        m_north_open[col] = !south;
+        m_north_east_open[col] = !east;
+    }
+
+  private:
+    // one extra column so the north east lookup of the last cell reads a closed wall
+    std::vector<uint8_t> m_north_open;
+    std::vector<uint8_t> m_north_east_open;
+    bool m_west_open{false};
+    bool m_south_west_open{false};
+};
+
+// Cells covered by a chunk, clipped at the maze border.
+struct ChunkArea {
+    std::size_t first_col;
+    std::size_t first_row;
+    std::size_t cols;
+    std::size_t rows;
+};
+
+inline ChunkArea chunk_area(const Header& header, std::size_t chunk_x, std::size_t chunk_y) {
+    auto first_col{chunk_x * header.chunk_size};
+    auto first_row{chunk_y * header.chunk_size};
+    return {first_col,
+            first_row,
+            std::min<std::size_t>(header.chunk_size, header.cols - first_col),
+            std::min<std::size_t>(header.chunk_size, header.rows - first_row)};
+}
+
+inline std::vector<uint8_t> encode_chunk(const WallGrid& walls, const ChunkArea& area) {
+    std::vector<uint8_t> bytes;
+    RangeEncoder encoder(bytes);
+    Contexts contexts;
+    Neighbourhood open(area.cols);
+    for (std::size_t row = 0; row < area.rows; ++row) {
+        open.start_row();
+        for (std::size_t col = 0; col < area.cols; ++col) {
+            bool east{walls.east().test(area.first_col + col, area.first_row + row)};
+            bool south{walls.south().test(area.first_col + col, area.first_row + row)};
+            encoder.encode(contexts.east[open.east_context(col)], east);
+            encoder.encode(contexts.south[open.south_context(col, east)], south);
+            open.update(col, east, south);
+        }
+    }
+    encoder.flush();
+    return bytes;
+}
+
+// Decodes a chunk and opens the walls of the cells which fall into `region`, given in maze cells. `walls` covers
+// exactly the region and starts with all walls standing.
+inline void decode_chunk(const std::vector<uint8_t>& bytes,
+                         const ChunkArea& area,
+                         const ChunkArea& region,
+                         WallGrid& walls) {
+    RangeDecoder decoder(bytes.data(), bytes.size());
+    Contexts contexts;
+    Neighbourhood open(area.cols);
+    auto last_row{std::min(area.rows, region.first_row + region.rows - area.first_row)};
+    for (std::size_t row = 0; row < last_row; ++row) {
+        auto maze_row{area.first_row + row};
+        bool row_inside{maze_row >= region.first_row};
+        open.start_row();
+        for (std::size_t col = 0; col < area.cols; ++col) {
+            bool east{decoder.decode(contexts.east[open.east_context(col)])};
+            bool south{decoder.decode(contexts.south[open.south_context(col, east)])};
+            open.update(col, east, south);
+
+            auto maze_col{area.first_col + col};
+            if (!row_inside || maze_col < region.first_col || maze_col >= region.first_col + region.cols) {
+                continue;
+            }
+            if (!east) {
+                walls.east().reset(maze_col - region.first_col, maze_row - region.first_row);
+            }
+            if (!south) {
+                walls.south().reset(maze_col - region.first_col, maze_row - region.first_row);
+            }
+        }
+    }
+}
+} // namespace chunked_file
+
+inline bool save_chunked(const Maze& maze, const std::string& path, uint32_t chunk_size = chunked_file::CHUNK_SIZE) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    chunked_file::Header header{chunked_file::MAGIC,
+                                chunked_file::VERSION,
+                                std::to_underlying(maze.algorithm()),
+                                std::to_underlying(maze.wrap()),
+                                static_cast<uint32_t>(maze.cols()),
+                                static_cast<uint32_t>(maze.rows()),
+                                chunk_size,
+                                static_cast<uint32_t>((maze.cols() + chunk_size - 1) / chunk_size),
+                                static_cast<uint32_t>((maze.rows() + chunk_size - 1) / chunk_size),
+                                0,
+                                maze.seed(),
+                                0};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<chunked_file::ChunkEntry> index;
+    index.reserve(static_cast<std::size_t>(header.chunks_x) * header.chunks_y);
+    uint64_t offset{sizeof(header)};
+    for (std::size_t chunk_y = 0; chunk_y < header.chunks_y; ++chunk_y) {
+        for (std::size_t chunk_x = 0; chunk_x < header.chunks_x; ++chunk_x) {
+            auto bytes{chunked_file::encode_chunk(maze.walls(), chunked_file::chunk_area(header, chunk_x, chunk_y))};
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            index.push_back({offset, bytes.size()});
+            offset += bytes.size();
+        }
+    }
+    file.write(reinterpret_cast<const char*>(index.data()),
+               static_cast<std::streamsize>(index.size() * sizeof(chunked_file::ChunkEntry)));
+
+    header.index_offset = offset;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(file);
+}
+
+// Reads regions of a chunked maze file, keeping only the header and the chunk index in memory.
+class ChunkedMazeReader {
+  public:
+    bool open(const std::string& path) {
+        m_file = std::ifstream(path, std::ios::binary);
+        if (!m_file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header))) {
+            return false;
+        }
+        auto chunks = [&](uint64_t cells) { return (cells + m_header.chunk_size - 1) / m_header.chunk_size; };
+        if (m_header.magic != chunked_file::MAGIC || m_header.version != chunked_file::VERSION ||
+            m_header.algorithm > std::to_underlying(LAST_ALGORITHM) ||
+            m_header.wrap > std::to_underlying(Wrap::Torus) || m_header.cols == 0 || m_header.rows == 0 ||
+            m_header.chunk_size == 0 ||
+            m_header.chunks_x != chunks(m_header.cols) || m_header.chunks_y != chunks(m_header.rows)) {
+            return false;
+        }
+        // the chunk counts come from the file, so the index has to fit into it before any memory is spent on it
+        m_file.seekg(0, std::ios::end);
+        auto file_size{static_cast<uint64_t>(m_file.tellg())};
+        uint64_t index_bytes{0};
+        uint64_t index_end{0};
+        if (__builtin_mul_overflow(uint64_t{m_header.chunks_x} * m_header.chunks_y, sizeof(chunked_file::ChunkEntry),
+                                   &index_bytes) ||
+            __builtin_add_overflow(m_header.index_offset, index_bytes, &index_end) || index_end > file_size) {
+            return false;
+        }
+        m_index.resize(static_cast<std::size_t>(m_header.chunks_x) * m_header.chunks_y);
+        m_file.seekg(static_cast<std::streamoff>(m_header.index_offset));
+        if (!m_file.read(reinterpret_cast<char*>(m_index.data()), static_cast<std::streamsize>(index_bytes))) {
+            return false;
+        }
+        return std::ranges::all_of(m_index, [&](const chunked_file::ChunkEntry& entry) {
+            uint64_t end{0};
+            return entry.offset >= sizeof(m_header) && !__builtin_add_overflow(entry.offset, entry.size, &end) &&
+                   end <= m_header.index_offset;
+        });
+    }
+
+    const chunked_file::Header& header() const {
+        return m_header;
+    }
+
+    std::size_t chunks_decoded() const {
+        return m_chunks_decoded;
+    }
+
+    // Walls of the cells in the given region, decoding only the chunks overlapping it. Walls leading out of the region
+    // are kept as they are in the full maze.
+    std::optional<WallGrid>
+    read_region(std::size_t first_col, std::size_t first_row, std::size_t cols, std::size_t rows) {
+        if (cols == 0 || rows == 0 || first_col > m_header.cols || cols > m_header.cols - first_col ||
+            first_row > m_header.rows || rows > m_header.rows - first_row) {
+            return std::nullopt;
+        }
+        chunked_file::ChunkArea region{first_col, first_row, cols, rows};
+        WallGrid walls(cols, rows);
+        std::vector<uint8_t> bytes;
+        auto chunk_size{static_cast<std::size_t>(m_header.chunk_size)};
+        for (auto chunk_y = first_row / chunk_size; chunk_y <= (first_row + rows - 1) / chunk_size; ++chunk_y) {
+            for (auto chunk_x = first_col / chunk_size; chunk_x <= (first_col + cols - 1) / chunk_size; ++chunk_x) {
+                const auto& entry{m_index[chunk_y * m_header.chunks_x + chunk_x]};
+                bytes.resize(entry.size);
+                m_file.seekg(static_cast<std::streamoff>(entry.offset));
+                if (!m_file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+                    return std::nullopt;
+                }
+                chunked_file::decode_chunk(bytes, chunked_file::chunk_area(m_header, chunk_x, chunk_y), region, walls);
+                ++m_chunks_decoded;
+            }
+        }
+        return walls;
+    }
+
+    // Decodes the whole file into a finished maze.
+    std::unique_ptr<Maze> load(std::size_t cell_width, std::size_t cell_height) {
+        auto walls{read_region(0, 0, m_header.cols, m_header.rows)};
+        if (!walls) {
+            return nullptr;
+        }
+        return std::make_unique<Maze>(std::move(*walls),
+                                      cell_width,
+                                      cell_height,
+                                      m_header.seed,
+                                      static_cast<Algorithm>(m_header.algorithm),
+                                      static_cast<Wrap>(m_header.wrap));
+    }
+
+  private:
+    std::ifstream m_file;
+    chunked_file::Header m_header{};
+    std::vector<chunked_file::ChunkEntry> m_index;
+    std::size_t m_chunks_decoded{0};
+};
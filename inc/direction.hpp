@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// The first four lie in the plane of a layer, `Up` and `Down` lead to the neighbouring layers of a layered maze.
+enum class Direction : uint8_t { North, East, South, West, Up, Down, NUM };
+
+constexpr bool is_planar(Direction direction) {
+    return direction < Direction::Up;
+}
+
+constexpr Direction opposite(Direction direction) {
+    switch (direction) {
+        case Direction::North:
+            return Direction::South;
+        case Direction::East:
+            return Direction::West;
+        case Direction::South:
+            return Direction::North;
+        case Direction::West:
+            return Direction::East;
+        case Direction::Up:
+            return Direction::Down;
+        case Direction::Down:
+            return Direction::Up;
+        default:
+            return Direction::NUM;
+    }
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "generator.hpp"
+#include "maze_event.hpp"
+#include "wrap.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Binary stream of maze events.
+// The header holds the magic "MZEV", a version byte, the wrap byte, the maze size and the solver goal (little endian
+// u32 each). Every
+// event is one tag byte (kind in bits 0-1, direction in bits 2-4) followed by the zigzag LEB128 encoded difference to
+// the previous event's cell index, most events therefore take 2 bytes.
+namespace event_stream {
+constexpr static std::array<char, 4> MAGIC{'M', 'Z', 'E', 'V'};
+constexpr static uint8_t VERSION{2};
+constexpr static auto HEADER_SIZE{MAGIC.size() + 2 + 3 * sizeof(uint32_t)};
+
+struct Header {
+    Wrap wrap{Wrap::None};
+    uint32_t cols{0};
+    uint32_t rows{0};
+    uint32_t goal{0};
+};
+} // namespace event_stream
+
+class EventRecorder {
+    constexpr static std::size_t FLUSH_SIZE{1 << 16};
+
+  public:
+    EventRecorder() = default;
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    ~EventRecorder() {
+        close();
+    }
+
+    bool open(const std::string& path, const event_stream::Header& header) {
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file) {
+            return false;
+        }
+        m_buffer.insert(m_buffer.end(), event_stream::MAGIC.begin(), event_stream::MAGIC.end());
+        m_buffer.push_back(event_stream::VERSION);
+        m_buffer.push_back(static_cast<char>(std::to_underlying(header.wrap)));
+        for (auto value : {header.cols, header.rows, header.goal}) {
+            for (auto shift : {0U, 8U, 16U, 24U}) {
+                m_buffer.push_back(static_cast<char>(value >> shift));
+            }
+        }
+        m_previous_index = 0;
+        return true;
+    }
+
+    bool is_open() const {
+        return m_file.is_open();
+    }
+
+    void record(const MazeEvent& event) {
+        auto tag{std::to_underlying(event.kind) | (std::to_underlying(event.direction) << 2)};
+        m_buffer.push_back(static_cast<char>(tag));
+        auto delta{static_cast<int64_t>(event.index) - static_cast<int64_t>(m_previous_index)};
+        auto zigzag{(static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63)};
+        while (zigzag >= 0x80) {
+            m_buffer.push_back(static_cast<char>((zigzag & 0x7F) | 0x80));
+            zigzag >>= 7;
+        }
+        m_buffer.push_back(static_cast<char>(zigzag));
+        m_previous_index = event.index;
+
+        if (m_buffer.size() >= FLUSH_SIZE) {
+            flush();
+        }
+    }
+
+    void close() {
+        if (m_file.is_open()) {
+            flush();
+            m_file.close();
+        }
+    }
+
+  private:
+    void flush() {
+        m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+    }
+
+    std::ofstream m_file;
+    std::vector<char> m_buffer;
+    uint32_t m_previous_index{0};
+};
+
+class EventReplayer {
+  public:
+    bool open(const std::string& path) {
+        m_file.open(path, std::ios::binary);
+        std::array<char, event_stream::HEADER_SIZE> header{};
+        if (!m_file.read(header.data(), header.size()) ||
+            !std::equal(event_stream::MAGIC.begin(), event_stream::MAGIC.end(), header.begin()) ||
+            static_cast<uint8_t>(header[event_stream::MAGIC.size()]) != event_stream::VERSION) {
+            return false;
+        }
+        auto read_u32 = [&](std::size_t offset) {
+            uint32_t value{0};
+            for (auto byte : {3U, 2U, 1U, 0U}) {
+                value = (value << 8) | static_cast<uint8_t>(header[offset + byte]);
+            }
+            return value;
+        };
+        auto wrap{static_cast<uint8_t>(header[event_stream::MAGIC.size() + 1])};
+        if (wrap > std::to_underlying(Wrap::Torus)) {
+            return false;
+        }
+        constexpr auto first_field{event_stream::MAGIC.size() + 2};
+        m_header = {
+            static_cast<Wrap>(wrap), read_u32(first_field), read_u32(first_field + 4), read_u32(first_field + 8)};
+        return m_header.cols > 0 && m_header.rows > 0 &&
+               m_header.goal < static_cast<uint64_t>(m_header.cols) * m_header.rows;
+    }
+
+    const event_stream::Header& header() const {
+        return m_header;
+    }
+
+    // Decodes the recorded events one at a time, a truncated or corrupt stream simply ends early.
+    Generator<MazeEvent> events() {
+        std::istreambuf_iterator<char> it{m_file};
+        std::istreambuf_iterator<char> end;
+        uint32_t previous_index{0};
+        while (it != end) {
+            auto tag{static_cast<uint8_t>(*it++)};
+            uint64_t zigzag{0};
+            uint32_t shift{0};
+            bool complete{false};
+            while (it != end && shift < 64) {
+                auto byte{static_cast<uint8_t>(*it++)};
+                zigzag |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                shift += 7;
+                if ((byte & 0x80) == 0) {
+                    complete = true;
+                    break;
+                }
+            }
+            if (!complete) {
+                co_return;
+            }
+            auto delta{static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1)};
+            auto index{static_cast<int64_t>(previous_index) + delta};
+            auto direction{static_cast<Direction>((tag >> 2) & 0x07)};
+            auto kind{static_cast<MazeEvent::Kind>(tag & 0x03)};
+            if (index < 0 || index >= static_cast<int64_t>(m_header.cols) * m_header.rows ||
+                (!is_planar(direction) && direction != Direction::NUM)) {
+                co_return;
+            }
+            previous_index = static_cast<uint32_t>(index);
+            // carves and path steps lead to a neighbour, which has to exist in the recorded maze
+            if ((kind == MazeEvent::Kind::Carve || kind == MazeEvent::Kind::Path) &&
+                !has_neighbour(previous_index, direction)) {
+                co_return;
+            }
+            co_yield MazeEvent{kind, direction, previous_index};
+        }
+    }
+
+  private:
+    // Whether the cell at `index` has a neighbour in `direction` in a maze of the header's size and wrap.
+    bool has_neighbour(uint32_t index, Direction direction) const {
+        auto col{index % m_header.cols};
+        auto row{index / m_header.cols};
+        switch (direction) {
+            case Direction::North:
+                return row > 0 || m_header.wrap == Wrap::Torus;
+            case Direction::East:
+                return col + 1 < m_header.cols || m_header.wrap != Wrap::None;
+            case Direction::South:
+                return row + 1 < m_header.rows || m_header.wrap == Wrap::Torus;
+            case Direction::West:
+                return col > 0 || m_header.wrap != Wrap::None;
+            default:
+                return false;
+        }
+    }
+
+    std::ifstream m_file;
+    event_stream::Header m_header;
+};
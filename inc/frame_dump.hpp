@@ -0,0 +1,144 @@
+#pragma once
+
+#include "olcPixelGameEngine.h"
+
+#include "maze.hpp"
+#include "maze_event.hpp"
+#include "tile.hpp"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <ranges>
+#include <vector>
+
+// Renders a maze into an offscreen YUV 4:4:4 frame and writes it as a YUV4MPEG2 stream, e.g. piped into ffmpeg.
+// Only cells touched by events since the last frame are repainted, the full frame is painted once up front.
+class FrameDumper {
+    constexpr static auto WALL_WIDTH{1};
+    constexpr static auto NO_HIGHLIGHT{std::numeric_limits<std::size_t>::max()};
+
+  public:
+    FrameDumper(const Maze& maze, int32_t cell_width, int32_t cell_height, std::FILE* output) :
+        m_maze(maze),
+        m_cell_w(cell_width),
+        m_cell_h(cell_height),
+        m_width(static_cast<std::size_t>(maze.cols()) * static_cast<std::size_t>(cell_width + WALL_WIDTH)),
+        m_height(static_cast<std::size_t>(maze.rows()) * static_cast<std::size_t>(cell_height + WALL_WIDTH)),
+        m_planes{std::vector<uint8_t>(m_width * m_height),
+                 std::vector<uint8_t>(m_width * m_height),
+                 std::vector<uint8_t>(m_width * m_height)},
+        m_dirty(maze.size()),
+        m_on_path(maze.size(), false),
+        m_output(output) {
+        std::fprintf(m_output, "YUV4MPEG2 W%zu H%zu F30:1 Ip A1:1 C444\n", m_width, m_height);
+        for (std::size_t index : std::views::iota(std::size_t(0), maze.size())) {
+            paint(index);
+        }
+    }
+
+    // Marks the cells changed by an event, the most recent cell is highlighted like in the window.
+    void apply(const MazeEvent& event) {
+        m_dirty.mark(m_maze, event);
+        // a step out of the maze from a corrupt recording leads nowhere
+        auto neighbour{m_maze.neighbour_index(event.index, event.direction)};
+        switch (event.kind) {
+            case MazeEvent::Kind::Carve: {
+                highlight((neighbour != Maze::NO_NEIGHBOUR) ? neighbour : event.index, olc::GREEN);
+            } break;
+            case MazeEvent::Kind::Backtrack: {
+                highlight(event.index, olc::GREEN);
+            } break;
+            case MazeEvent::Kind::Expand: {
+                highlight(event.index, olc::MAGENTA);
+            } break;
+            case MazeEvent::Kind::Path: {
+                m_on_path[event.index] = true;
+                if (neighbour != Maze::NO_NEIGHBOUR) {
+                    m_on_path[neighbour] = true;
+                }
+                highlight(NO_HIGHLIGHT, olc::BLACK);
+            } break;
+        }
+    }
+
+    bool write_frame() {
+        m_dirty.drain([&](std::size_t index) { paint(index); });
+
+        std::fputs("FRAME\n", m_output);
+        for (auto& plane : m_planes) {
+            if (std::fwrite(plane.data(), 1, plane.size(), m_output) != plane.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    void highlight(std::size_t index, olc::Pixel color) {
+        if (m_highlight != NO_HIGHLIGHT) {
+            m_dirty.mark(m_highlight);
+        }
+        m_highlight = index;
+        m_highlight_color = color;
+        if (m_highlight != NO_HIGHLIGHT) {
+            m_dirty.mark(m_highlight);
+        }
+    }
+
+    // Paints the cell including its east and south wall.
+    void paint(std::size_t index) {
+        auto cell{m_maze.cell(index)};
+        auto color{Maze::cell_color(cell)};
+        if (index == m_highlight) {
+            color = m_highlight_color;
+        } else if (m_on_path[index]) {
+            color = olc::YELLOW;
+        }
+        auto colors{tile_colors(cell, color)};
+        if (index == m_highlight) {
+            colors.inside = color;
+        }
+        auto inside{to_yuv(colors.inside)};
+        auto east{to_yuv(colors.east)};
+        auto south{to_yuv(colors.south)};
+        auto corner{to_yuv(colors.corner)};
+
+        auto x0{static_cast<std::size_t>(cell.m_x) * static_cast<std::size_t>(m_cell_w + WALL_WIDTH)};
+        auto y0{static_cast<std::size_t>(cell.m_y) * static_cast<std::size_t>(m_cell_h + WALL_WIDTH)};
+        for (std::size_t plane : std::views::iota(std::size_t(0), m_planes.size())) {
+            paint_tile(m_planes[plane].data() + y0 * m_width + x0,
+                       m_width,
+                       static_cast<std::size_t>(m_cell_w),
+                       static_cast<std::size_t>(m_cell_h),
+                       inside[plane],
+                       east[plane],
+                       south[plane],
+                       corner[plane]);
+        }
+    }
+
+    // BT.601 studio swing.
+    static std::array<uint8_t, 3> to_yuv(olc::Pixel color) {
+        int32_t r{color.r};
+        int32_t g{color.g};
+        int32_t b{color.b};
+        return {static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16),
+                static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128),
+                static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128)};
+    }
+
+    const Maze& m_maze;
+    int32_t m_cell_w;
+    int32_t m_cell_h;
+    std::size_t m_width;
+    std::size_t m_height;
+    std::array<std::vector<uint8_t>, 3> m_planes;
+
+    DirtyCells m_dirty;
+    std::vector<bool> m_on_path;
+    std::size_t m_highlight{NO_HIGHLIGHT};
+    olc::Pixel m_highlight_color{olc::GREEN};
+
+    std::FILE* m_output;
+};
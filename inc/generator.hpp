@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <utility>
+
+// Coroutine frames of finished generators are kept in per thread free lists by size, rounded up to a power of two, and
+// handed to the next generator of that size. Generators started over and over, one per maze of a batch, so allocate
+// nothing once the lists are filled.
+namespace frame_pool {
+// frames up to 64 KiB are kept, at most `KEPT` of each size
+constexpr static std::size_t SIZES{17};
+constexpr static std::size_t KEPT{16};
+
+struct FreeLists {
+    struct Free {
+        Free* next;
+    };
+
+    std::array<Free*, SIZES> heads{};
+    std::array<std::size_t, SIZES> counts{};
+
+    ~FreeLists() {
+        for (auto* head : heads) {
+            while (head) {
+                ::operator delete(std::exchange(head, head->next));
+            }
+        }
+    }
+};
+
+inline thread_local FreeLists t_free_lists;
+
+inline std::size_t size_index(std::size_t size) {
+    return static_cast<std::size_t>(std::countr_zero(std::bit_ceil(std::max(size, sizeof(FreeLists::Free)))));
+}
+
+inline void* allocate(std::size_t size) {
+    auto index{size_index(size)};
+    if (index >= SIZES) {
+        return ::operator new(size);
+    }
+    auto& lists{t_free_lists};
+    if (auto* frame{lists.heads[index]}) {
+        lists.heads[index] = frame->next;
+        --lists.counts[index];
+        return frame;
+    }
+    return ::operator new(std::size_t(1) << index);
+}
+
+inline void release(void* frame, std::size_t size) noexcept {
+    auto index{size_index(size)};
+    auto& lists{t_free_lists};
+    if (index >= SIZES || lists.counts[index] == KEPT) {
+        ::operator delete(frame);
+        return;
+    }
+    lists.heads[index] = ::new (frame) FreeLists::Free{lists.heads[index]};
+    ++lists.counts[index];
+}
+} // namespace frame_pool
+
+// Minimal lazy coroutine generator, the algorithms `co_yield` their steps and the caller pulls them one at a time.
+template <typename T>
+class Generator {
+  public:
+    struct promise_type {
+        static void* operator new(std::size_t size) {
+            return frame_pool::allocate(size);
+        }
+
+        static void operator delete(void* frame, std::size_t size) noexcept {
+            frame_pool::release(frame, size);
+        }
+
+        Generator get_return_object() {
+            return Generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always yield_value(T value) noexcept {
+            m_value = std::move(value);
+            return {};
+        }
+
+        void return_void() noexcept {
+        }
+
+        void unhandled_exception() {
+            throw;
+        }
+
+        T m_value;
+    };
+
+    class Iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+
+        Iterator() = default;
+        explicit Iterator(Generator* generator) : m_generator(generator) {};
+
+        const T& operator*() const {
+            return m_generator->value();
+        }
+
+        Iterator& operator++() {
+            if (!m_generator->next()) {
+                m_generator = nullptr;
+            }
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const {
+            return m_generator == nullptr;
+        }
+
+      private:
+        Generator* m_generator{nullptr};
+    };
+
+    Generator() = default;
+
+    explicit Generator(std::coroutine_handle<promise_type> handle) : m_handle(handle) {};
+
+    Generator(Generator&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {};
+
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            reset();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    ~Generator() {
+        reset();
+    }
+
+    // Runs the algorithm up to its next step, returns false once it finished.
+    bool next() {
+        if (!m_handle || m_handle.done()) {
+            return false;
+        }
+        m_handle.resume();
+        return !m_handle.done();
+    }
+
+    const T& value() const {
+        return m_handle.promise().m_value;
+    }
+
+    bool done() const {
+        return !m_handle || m_handle.done();
+    }
+
+    Iterator begin() {
+        Iterator it{this};
+        return ++it;
+    }
+
+    std::default_sentinel_t end() {
+        return {};
+    }
+
+  private:
+    void reset() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+        m_handle = nullptr;
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "algorithm.hpp"
+#include "maze.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+// Every generator of the square maze by name. An entry points to the coroutine yielding the generator's events and,
+// for generators that can, to the in place carver running on several threads. Picking a generator costs one indirect
+// call per maze, the loops behind it are the member templates of `Maze` and never dispatch per cell.
+namespace generators {
+struct Entry {
+    std::string_view name;
+    Algorithm algorithm;
+    // grows cell by cell from the start cell, so it also generates within a mask
+    bool grows_from_start;
+    Generator<MazeEvent> (*events)(Maze& maze, uint64_t seed);
+    // same walls as `events` but without any events, nullptr if there is no such carver
+    void (*carve)(Maze& maze, uint64_t seed, std::size_t threads);
+    // most cells the generator can carve
+    std::size_t max_cells{std::numeric_limits<std::size_t>::max()};
+};
+
+constexpr static std::array<Entry, 12> ENTRIES{{
+    {"backtracker",
+     Algorithm::Backtracker,
+     true,
+     [](Maze& maze, uint64_t seed) { return maze.generate(seed); },
+     nullptr},
+    {"hunt-and-kill",
+     Algorithm::HuntAndKill,
+     true,
+     [](Maze& maze, uint64_t seed) { return maze.hunt_and_kill(seed); },
+     nullptr},
+    {"prim",
+     Algorithm::Prim,
+     true,
+     [](Maze& maze, uint64_t seed) { return maze.prim(seed); },
+     nullptr},
+    {"growing-tree-newest",
+     Algorithm::GrowingTreeNewest,
+     true,
+     [](Maze& maze, uint64_t seed) { return maze.grow<growing_tree::NewestCell>(seed); },
+     nullptr},
+    {"growing-tree-random",
+     Algorithm::GrowingTreeRandom,
+     true,
+     [](Maze& maze, uint64_t seed) { return maze.grow<growing_tree::RandomCell>(seed); },
+     nullptr},
+    {"growing-tree-oldest",
+     Algorithm::GrowingTreeOldest,
+     true,
+     [](Maze& maze, uint64_t seed) { return maze.grow<growing_tree::OldestCell>(seed); },
+     nullptr},
+    {"growing-tree-mixed",
+     Algorithm::GrowingTreeMixed,
+     true,
+     [](Maze& maze, uint64_t seed) { return maze.grow<growing_tree::MixedCell<50>>(seed); },
+     nullptr},
+    {"aldous-broder",
+     Algorithm::AldousBroder,
+     true,
+     [](Maze& maze, uint64_t seed) { return maze.aldous_broder(seed); },
+     nullptr},
+    {"wilson",
+     Algorithm::Wilson,
+     false,
+     [](Maze& maze, uint64_t seed) { return maze.generate_wilson(seed); },
+     [](Maze& maze, uint64_t seed, std::size_t threads) { maze.wilson(seed, threads); },
+     wilson::MAX_CELLS},
+    {"binary-tree",
+     Algorithm::BinaryTree,
+     false,
+     [](Maze& maze, uint64_t seed) { return maze.generate_rows(seed, Algorithm::BinaryTree); },
+     [](Maze& maze, uint64_t seed, std::size_t threads) { maze.carve_rows(seed, Algorithm::BinaryTree, threads); }},
+    {"sidewinder",
+     Algorithm::Sidewinder,
+     false,
+     [](Maze& maze, uint64_t seed) { return maze.generate_rows(seed, Algorithm::Sidewinder); },
+     [](Maze& maze, uint64_t seed, std::size_t threads) { maze.carve_rows(seed, Algorithm::Sidewinder, threads); }},
+    {"recursive-division",
+     Algorithm::RecursiveDivision,
+     false,
+     [](Maze& maze, uint64_t seed) { return maze.generate_divided(seed); },
+     [](Maze& maze, uint64_t seed, std::size_t threads) { maze.divide(seed, threads); }},
+}};
+
+// Entry called `name`, nullptr if there is none.
+constexpr const Entry* find(std::string_view name) {
+    for (const auto& entry : ENTRIES) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+// Entry generating `algorithm`, the backtracker for mazes that weren't generated here.
+constexpr const Entry& find(Algorithm algorithm) {
+    for (const auto& entry : ENTRIES) {
+        if (entry.algorithm == algorithm) {
+            return entry;
+        }
+    }
+    return ENTRIES.front();
+}
+
+// Whether `entry` can generate `maze`, within a mask only the generators growing from the start cell stay inside it.
+inline bool supports(const Entry& entry, const Maze& maze) {
+    return (entry.grows_from_start || !maze.is_masked()) && maze.size() <= entry.max_cells;
+}
+
+// Generates `maze` with `algorithm`, nothing if the generator doesn't support the maze.
+inline std::optional<Generator<MazeEvent>> generate(Maze& maze, uint64_t seed, Algorithm algorithm) {
+    const auto& entry{find(algorithm)};
+    if (!supports(entry, maze)) {
+        return std::nullopt;
+    }
+    return entry.events(maze, seed);
+}
+
+// Carves `maze` with `algorithm` on `threads` threads without any events, false if the generator has no such carver or
+// doesn't support the maze.
+inline bool carve(Maze& maze, uint64_t seed, Algorithm algorithm, std::size_t threads) {
+    const auto& entry{find(algorithm)};
+    if (!entry.carve || !supports(entry, maze)) {
+        return false;
+    }
+    entry.carve(maze, seed, threads);
+    return true;
+}
+} // namespace generators
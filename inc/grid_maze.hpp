@@ -0,0 +1,144 @@
+#pragma once
+
+#include "bit_plane.hpp"
+#include "bucket_queue.hpp"
+#include "generator.hpp"
+#include "grid_search.hpp"
+#include "maze_event.hpp"
+#include "topology.hpp"
+#include <cstdint>
+#include <vector>
+
+// A step of an algorithm on a `GridMaze`, like `MazeEvent` but with a side of the topology instead of a direction.
+struct GridEvent {
+    MazeEvent::Kind kind{MazeEvent::Kind::Carve};
+    uint8_t side{0};
+    uint32_t index{0};
+};
+
+// Maze over any topology of `topology.hpp`. The topology is a template parameter, so the neighbour loops of the
+// generator and the solver, those of `GridSearch`, run over fixed size arrays known at compile time. Every cell keeps a
+// bit per open side.
+template <typename Topology>
+class GridMaze {
+    static_assert(Topology::SIDES <= 8, "the open sides of a cell are stored in a byte");
+
+  public:
+    GridMaze(std::size_t cols, std::size_t rows) :
+        m_cols(cols), m_rows(rows), m_open(cols * rows, 0), m_visited(cols, rows, false) {
+        m_visited.set(0, 0);
+    }
+
+    std::size_t cols() const {
+        return m_cols;
+    }
+
+    std::size_t rows() const {
+        return m_rows;
+    }
+
+    std::size_t size() const {
+        return m_cols * m_rows;
+    }
+
+    bool is_open(std::size_t index, std::size_t side) const {
+        return (m_open[index] >> side) & 1;
+    }
+
+    // Recursive backtracker starting in the top left cell.
+    Generator<GridEvent> generate(uint64_t seed) {
+        return GridSearch::backtrack(*this, seed, 0, m_stack, m_stack_bytes);
+    }
+
+    // A* from `start` to `goal` with the distance of the topology as heuristic, yields every expanded cell once its
+    // neighbours are scored and once the goal is reached the path back to `start`.
+    Generator<GridEvent> solve(std::size_t start, std::size_t goal) {
+        return GridSearch::solve(*this, start, goal, m_g_score, m_came_from, m_open_set);
+    }
+
+    // Neighbour behind `side`, which has to exist.
+    std::size_t neighbour_index(std::size_t index, uint8_t side) const {
+        auto col{index % m_cols};
+        auto row{index / m_cols};
+        auto offset{Topology::OFFSETS[Topology::kind(col, row)][side]};
+        return (row + static_cast<std::size_t>(offset.row)) * m_cols + col + static_cast<std::size_t>(offset.col);
+    }
+
+  private:
+    friend struct GridSearch;
+    using Step = uint8_t;
+    using Event = GridEvent;
+    using Sides = GridSearch::Steps<uint8_t, Topology::SIDES>;
+    constexpr static auto NO_STEP{static_cast<uint8_t>(Topology::SIDES)};
+
+    static GridEvent event(MazeEvent::Kind kind, uint8_t side, std::size_t index) {
+        return {kind, side, static_cast<uint32_t>(index)};
+    }
+
+    static uint8_t opposite_step(uint8_t side) {
+        return static_cast<uint8_t>(Topology::opposite(side));
+    }
+
+    // Every step costs 1.
+    static int32_t cost(std::size_t) {
+        return 1;
+    }
+
+    static uint32_t cost_span() {
+        return 2;
+    }
+
+    // Sides of the neighbours inside the grid for which `accept(col, row)` holds.
+    template <typename Accept>
+    Sides sides(std::size_t index, Accept&& accept) const {
+        auto col{index % m_cols};
+        auto row{index / m_cols};
+        const auto& offsets{Topology::OFFSETS[Topology::kind(col, row)]};
+        Sides result;
+        for (std::size_t side = 0; side < Topology::SIDES; ++side) {
+            // negative coordinates wrap around and fail the bounds check as well
+            auto neighbour_col{col + static_cast<std::size_t>(offsets[side].col)};
+            auto neighbour_row{row + static_cast<std::size_t>(offsets[side].row)};
+            if (neighbour_col < m_cols && neighbour_row < m_rows && accept(side, neighbour_col, neighbour_row)) {
+                result.steps[result.count++] = static_cast<uint8_t>(side);
+            }
+        }
+        return result;
+    }
+
+    Sides unvisited_steps(std::size_t index) const {
+        return sides(index, [&](std::size_t, std::size_t col, std::size_t row) { return !m_visited.test(col, row); });
+    }
+
+    Sides open_steps(std::size_t index) const {
+        return sides(index, [&](std::size_t side, std::size_t, std::size_t) { return is_open(index, side); });
+    }
+
+    // Opens the wall behind `side` in both cells and marks the neighbour visited.
+    void carve(std::size_t index, uint8_t side) {
+        auto neighbour{neighbour_index(index, side)};
+        m_visited.set(neighbour % m_cols, neighbour / m_cols);
+        m_open[index] |= static_cast<uint8_t>(1 << side);
+        m_open[neighbour] |= static_cast<uint8_t>(1 << Topology::opposite(side));
+    }
+
+    int32_t heuristic(std::size_t index, std::size_t goal) const {
+        return Topology::distance(static_cast<int32_t>(index % m_cols),
+                                  static_cast<int32_t>(index / m_cols),
+                                  static_cast<int32_t>(goal % m_cols),
+                                  static_cast<int32_t>(goal / m_cols));
+    }
+
+    std::size_t m_cols;
+    std::size_t m_rows;
+    // bit `side` set when the wall on that side is carved, both cells sharing a wall keep it
+    std::vector<uint8_t> m_open;
+    BitPlane m_visited;
+
+    // generator and solver scratch
+    std::vector<std::size_t> m_stack;
+    std::size_t m_stack_bytes{0};
+    std::vector<int32_t> m_g_score;
+    std::vector<uint8_t> m_came_from;
+    BucketQueue m_open_set;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "bucket_queue.hpp"
+#include "generator.hpp"
+#include "maze_event.hpp"
+#include "random.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// The recursive backtracker and A*, written once for every grid: the square `Maze` and the `GridMaze` of any topology.
+// The loops are templates on the grid, so the neighbour lookups are inlined and nothing dispatches per cell. A grid
+// befriends `GridSearch` and provides
+//   - `Step`, how to get from a cell to a neighbour, `NO_STEP`, and `Event`, the events it yields
+//   - `unvisited_steps(index)` and `open_steps(index)` as `Steps`, `neighbour_index(index, step)`
+//   - `carve(index, step)`, opening the wall and marking the neighbour visited
+//   - `cost(index)` of stepping into a cell, `cost_span()` covering the largest plus the smallest cost, and a
+//     consistent `heuristic(index, goal)`
+//   - `opposite_step(step)` and `event(kind, step, index)`
+struct GridSearch {
+    template <typename Step, std::size_t SIDES>
+    struct Steps {
+        std::array<Step, SIDES> steps;
+        std::size_t count{0};
+    };
+
+    constexpr static auto UNREACHED{std::numeric_limits<int32_t>::max()};
+
+    // Recursive backtracker from `start`, yields every carved wall and every backtracked cell. `stack` is the
+    // caller's so its memory outlives the maze, `peak_bytes` ends up as the most it held.
+    template <typename Grid>
+    static Generator<typename Grid::Event> backtrack(Grid& grid,
+                                                     uint64_t seed,
+                                                     std::size_t start,
+                                                     std::vector<std::size_t>& stack,
+                                                     std::size_t& peak_bytes) {
+        Random random(seed);
+        stack.clear();
+        stack.push_back(start);
+        peak_bytes = 0;
+
+        while (!stack.empty()) {
+            auto current{stack.back()};
+            peak_bytes = std::max(peak_bytes, stack.size() * sizeof(std::size_t));
+
+            auto unvisited{grid.unvisited_steps(current)};
+            if (unvisited.count > 0) {
+                auto step{unvisited.steps[random.below(unvisited.count)]};
+                auto neighbour{grid.neighbour_index(current, step)};
+                grid.carve(current, step);
+                stack.push_back(neighbour);
+                co_yield Grid::event(MazeEvent::Kind::Carve, step, current);
+            } else {
+                stack.pop_back();
+                co_yield Grid::event(MazeEvent::Kind::Backtrack, Grid::NO_STEP, current);
+            }
+        }
+    }
+
+    // A* from `start` to `goal`, yields every expanded cell once its neighbours are scored and once the goal is reached
+    // the path back to `start`. The heuristic is consistent, so the f score of a newly scored cell is at most
+    // `cost_span()` above that of the expanded cell and the open set is a bucket queue instead of a heap. A cell
+    // scored again for less moves to its new key, so every popped cell is expanded. The scores, the steps back and the
+    // queue are the caller's.
+    template <typename Grid>
+    static Generator<typename Grid::Event> solve(const Grid& grid,
+                                                 std::size_t start,
+                                                 std::size_t goal,
+                                                 std::vector<int32_t>& g_score,
+                                                 std::vector<typename Grid::Step>& came_from,
+                                                 BucketQueue& open_set) {
+        g_score.assign(grid.size(), UNREACHED);
+        came_from.assign(grid.size(), Grid::NO_STEP);
+        open_set.reset(grid.cost_span(), grid.size());
+        open_set.push(grid.heuristic(start, goal), start);
+        g_score[start] = 0;
+
+        while (!open_set.empty()) {
+            auto current{open_set.pop().second};
+
+            if (current == goal) {
+                co_yield Grid::event(MazeEvent::Kind::Expand, Grid::NO_STEP, current);
+                for (auto index{goal}; came_from[index] != Grid::NO_STEP;
+                     index = grid.neighbour_index(index, came_from[index])) {
+                    co_yield Grid::event(MazeEvent::Kind::Path, came_from[index], index);
+                }
+                co_return;
+            }
+
+            auto open{grid.open_steps(current)};
+            for (std::size_t i = 0; i < open.count; ++i) {
+                auto step{open.steps[i]};
+                auto neighbour{grid.neighbour_index(current, step)};
+                auto tentative_g_score{g_score[current] + grid.cost(neighbour)};
+                if (tentative_g_score < g_score[neighbour]) {
+                    came_from[neighbour] = Grid::opposite_step(step);
+                    g_score[neighbour] = tentative_g_score;
+                    open_set.push(tentative_g_score + grid.heuristic(neighbour, goal), neighbour);
+                }
+            }
+            co_yield Grid::event(MazeEvent::Kind::Expand, Grid::NO_STEP, current);
+        }
+    }
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "algorithm.hpp"
+#include "random.hpp"
+#include <cstdint>
+#include <vector>
+
+// Growing tree keeps a set of active cells and grows the maze from one of them at a time. Which one is up to a policy
+// type with a static `pick(size, random)` returning the position of the cell in the active set, 0 being the oldest.
+// Always taking the newest cell makes the long corridors of the backtracker, a random cell the short branches of Prim.
+namespace growing_tree {
+struct NewestCell {
+    constexpr static auto ALGORITHM{Algorithm::GrowingTreeNewest};
+
+    static std::size_t pick(std::size_t size, Random&) {
+        return size - 1;
+    }
+};
+
+struct RandomCell {
+    constexpr static auto ALGORITHM{Algorithm::GrowingTreeRandom};
+
+    static std::size_t pick(std::size_t size, Random& random) {
+        return random.below(size);
+    }
+};
+
+struct OldestCell {
+    constexpr static auto ALGORITHM{Algorithm::GrowingTreeOldest};
+
+    static std::size_t pick(std::size_t, Random&) {
+        return 0;
+    }
+};
+
+// The newest cell in `NEWEST_PERCENT` of the picks and a random one otherwise.
+template <uint32_t NEWEST_PERCENT>
+struct MixedCell {
+    constexpr static auto ALGORITHM{Algorithm::GrowingTreeMixed};
+
+    static std::size_t pick(std::size_t size, Random& random) {
+        return (random.below(100) < NEWEST_PERCENT) ? size - 1 : random.below(size);
+    }
+};
+
+// Active cells in the order they were added, in a flat vector. Removing the newest or the oldest cell keeps the order,
+// any other cell is replaced by the oldest, so every removal is O(1) amortized and the newest cell always stays last.
+class ActiveSet {
+  public:
+    bool empty() const {
+        return m_first == m_cells.size();
+    }
+
+    std::size_t size() const {
+        return m_cells.size() - m_first;
+    }
+
+    std::size_t operator[](std::size_t position) const {
+        return m_cells[m_first + position];
+    }
+
+    // Empties the set, keeping the memory for the next maze.
+    void clear() {
+        m_cells.clear();
+        m_first = 0;
+    }
+
+    void push(std::size_t cell) {
+        m_cells.push_back(cell);
+    }
+
+    std::size_t memory_usage() const {
+        return m_cells.capacity() * sizeof(std::size_t);
+    }
+
+    void remove(std::size_t position) {
+        if (position + 1 == size()) {
+            m_cells.pop_back();
+        } else {
+            m_cells[m_first + position] = m_cells[m_first];
+            ++m_first;
+        }
+        // once the removed cells make up half of the vector the active ones move to the front, which keeps it at
+        // most twice the size of the set at an amortized O(1)
+        if (m_first * 2 >= m_cells.size()) {
+            m_cells.erase(m_cells.begin(), m_cells.begin() + static_cast<std::ptrdiff_t>(m_first));
+            m_first = 0;
+        }
+    }
+
+  private:
+    std::vector<std::size_t> m_cells;
+    // the cells before it were removed
+    std::size_t m_first{0};
+};
+} // namespace growing_tree
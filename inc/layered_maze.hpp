@@ -0,0 +1,351 @@
+#pragma once
+
+#include "bit_plane.hpp"
+#include "direction.hpp"
+#include "maze_file.hpp"
+#include "random.hpp"
+#include "wall_grid.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// One level of a layered maze: its walls within the layer and `up`, which has a bit set where the ceiling towards the
+// next layer is closed.
+struct Layer {
+    WallGrid walls;
+    BitPlane up;
+};
+
+// Generates the layers of a perfect 3D maze one after the other with Eller's algorithm lifted from rows to layers and
+// hands each to `sink(z, layer)` before the next is started. Besides the layer only the sets its openings carry up
+// into the next layer are held in memory. Within a layer passages join cells of different sets in random order, then
+// every set opens upwards at a random cell of its own and now and then at others, so each pair of layers is joined in
+// several places. The last layer joins all remaining sets, which keeps the whole maze a tree.
+template <typename Sink>
+void generate_layers(std::size_t cols, std::size_t rows, std::size_t layers, uint64_t seed, Sink&& sink) {
+    // on every layer but the last one in SKIP_ODDS passages between different sets stays closed, and one in UP_ODDS
+    // cells opens upwards besides the one every set needs
+    constexpr static uint64_t SKIP_ODDS{4};
+    constexpr static uint64_t UP_ODDS{8};
+    constexpr static auto NONE{std::numeric_limits<std::size_t>::max()};
+
+    Random random(seed);
+    auto layer_size{cols * rows};
+    // set each cell was reached from the layer below, NONE if it wasn't
+    std::vector<std::size_t> below(layer_size, NONE);
+    std::vector<std::size_t> parent(layer_size);
+    // per set the first cell it reached in the layer, then the cell it opens upwards at for sure
+    std::vector<std::size_t> chosen(layer_size);
+    std::vector<std::size_t> count(layer_size);
+    // an east passage is `2 * cell`, a south passage `2 * cell + 1`
+    std::vector<std::size_t> passages;
+    passages.reserve(2 * layer_size);
+    auto find = [&](std::size_t cell) {
+        while (parent[cell] != cell) {
+            parent[cell] = parent[parent[cell]];
+            cell = parent[cell];
+        }
+        return cell;
+    };
+
+    for (std::size_t z = 0; z < layers; ++z) {
+        Layer layer{WallGrid(cols, rows), BitPlane(cols, rows, true)};
+        auto last{z + 1 == layers};
+
+        // cells reached by the same set below are already joined through it
+        std::iota(parent.begin(), parent.end(), std::size_t{0});
+        std::fill(chosen.begin(), chosen.end(), NONE);
+        for (std::size_t cell = 0; cell < layer_size; ++cell) {
+            if (below[cell] == NONE) {
+                continue;
+            }
+            if (chosen[below[cell]] == NONE) {
+                chosen[below[cell]] = cell;
+            } else {
+                parent[cell] = chosen[below[cell]];
+            }
+        }
+
+        passages.clear();
+        for (std::size_t cell = 0; cell < layer_size; ++cell) {
+            if (cell % cols + 1 < cols) {
+                passages.push_back(2 * cell);
+            }
+            if (cell / cols + 1 < rows) {
+                passages.push_back(2 * cell + 1);
+            }
+        }
+        for (auto i = passages.size(); i > 1; --i) {
+            std::swap(passages[i - 1], passages[random.below(i)]);
+        }
+        for (auto passage : passages) {
+            auto cell{passage / 2};
+            auto south{passage % 2 == 1};
+            auto root{find(cell)};
+            auto neighbour_root{find(south ? cell + cols : cell + 1)};
+            if (root == neighbour_root || (!last && random.below(SKIP_ODDS) == 0)) {
+                continue;
+            }
+            parent[neighbour_root] = root;
+            layer.walls.remove_wall(cell % cols, cell / cols, south ? Direction::South : Direction::East);
+        }
+
+        if (!last) {
+            // a uniformly random cell of every set, one pass over the layer
+            std::fill(count.begin(), count.end(), 0);
+            for (std::size_t cell = 0; cell < layer_size; ++cell) {
+                auto root{find(cell)};
+                if (random.below(++count[root]) == 0) {
+                    chosen[root] = cell;
+                }
+            }
+            for (std::size_t cell = 0; cell < layer_size; ++cell) {
+                auto root{find(cell)};
+                if (chosen[root] == cell || random.below(UP_ODDS) == 0) {
+                    layer.up.reset(cell % cols, cell / cols);
+                    below[cell] = root;
+                } else {
+                    below[cell] = NONE;
+                }
+            }
+        }
+        sink(z, layer);
+    }
+}
+
+// Layered maze file: a header in the first page followed by one block per layer with its east, south and up planes
+// laid out as in `BitPlane`. Every block starts on a page boundary, so a layer is paged in on its own.
+namespace layered_file {
+constexpr static std::array<char, 4> MAGIC{'M', 'Z', '3', 'D'};
+constexpr static uint16_t VERSION{1};
+
+struct Header {
+    std::array<char, 4> magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t cols;
+    uint32_t rows;
+    uint32_t layers;
+    uint32_t reserved2;
+    uint64_t seed;
+    uint64_t words_per_row;
+    uint64_t layer_stride;
+    uint64_t file_size;
+
+    bool operator==(const Header&) const = default;
+};
+static_assert(sizeof(Header) == 56);
+
+// Header of a file of `cols` x `rows` x `layers` cells, nothing if the size of the file doesn't fit in 64 bits.
+inline std::optional<Header> make_header(std::size_t cols, std::size_t rows, std::size_t layers, uint64_t seed) {
+    auto words_per_row{static_cast<uint64_t>(BitPlane::words_per_row(cols))};
+    uint64_t layer_bytes{0};
+    uint64_t layer_end{0};
+    if (__builtin_mul_overflow(3 * words_per_row * sizeof(uint64_t), rows, &layer_bytes) ||
+        __builtin_add_overflow(layer_bytes, maze_file::PAGE_SIZE - 1, &layer_end)) {
+        return std::nullopt;
+    }
+    auto layer_stride{maze_file::align_to_page(layer_bytes)};
+    uint64_t layers_bytes{0};
+    uint64_t file_size{0};
+    if (__builtin_mul_overflow(layer_stride, layers, &layers_bytes) ||
+        __builtin_add_overflow(maze_file::PAGE_SIZE, layers_bytes, &file_size)) {
+        return std::nullopt;
+    }
+    return Header{MAGIC,
+                  VERSION,
+                  0,
+                  static_cast<uint32_t>(cols),
+                  static_cast<uint32_t>(rows),
+                  static_cast<uint32_t>(layers),
+                  0,
+                  seed,
+                  words_per_row,
+                  layer_stride,
+                  file_size};
+}
+} // namespace layered_file
+
+// Generates a layered maze straight into a file, layer by layer.
+inline bool save_layers(
+    const std::string& path, std::size_t cols, std::size_t rows, std::size_t layers, uint64_t seed) {
+    auto header{layered_file::make_header(cols, rows, layers, seed)};
+    if (!header) {
+        return false;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&*header), sizeof(*header));
+    generate_layers(cols, rows, layers, seed, [&](std::size_t z, const Layer& layer) {
+        auto offset{maze_file::PAGE_SIZE + z * header->layer_stride};
+        std::string padding(offset - static_cast<uint64_t>(file.tellp()), '\0');
+        file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        for (const auto* plane : {&layer.walls.east(), &layer.walls.south(), &layer.up}) {
+            file.write(reinterpret_cast<const char*>(plane->data()),
+                       static_cast<std::streamsize>(plane->word_count() * sizeof(uint64_t)));
+        }
+    });
+    std::string padding(header->file_size - static_cast<uint64_t>(file.tellp()), '\0');
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    return static_cast<bool>(file);
+}
+
+// A maze of several layers stacked on top of each other, either held in memory or mapped read only from a layered
+// maze file. Cells are numbered layer by layer, so the cells of a layer are contiguous.
+class LayeredMaze {
+  public:
+    LayeredMaze() = default;
+    LayeredMaze(const LayeredMaze&) = delete;
+    LayeredMaze& operator=(const LayeredMaze&) = delete;
+
+    ~LayeredMaze() {
+        close();
+    }
+
+    void generate(std::size_t cols, std::size_t rows, std::size_t layers, uint64_t seed) {
+        close();
+        m_cols = cols;
+        m_rows = rows;
+        m_layers.reserve(layers);
+        generate_layers(cols, rows, layers, seed, [&](std::size_t, Layer& layer) {
+            m_layers.push_back(std::move(layer));
+        });
+    }
+
+    bool open(const std::string& path) {
+        close();
+        int fd{::open(path.c_str(), O_RDONLY)};
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status {};
+        if (::fstat(fd, &status) != 0 || static_cast<uint64_t>(status.st_size) < sizeof(layered_file::Header)) {
+            ::close(fd);
+            return false;
+        }
+        m_length = static_cast<std::size_t>(status.st_size);
+        m_mapping = ::mmap(nullptr, m_length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (m_mapping == MAP_FAILED) {
+            return false;
+        }
+
+        layered_file::Header header{};
+        std::memcpy(&header, m_mapping, sizeof(header));
+        // the sizes are read from the file, a header whose file size doesn't fit in 64 bits is refused
+        auto expected{layered_file::make_header(header.cols, header.rows, header.layers, header.seed)};
+        if (header.magic != layered_file::MAGIC || header.version != layered_file::VERSION || header.cols == 0 ||
+            header.rows == 0 || header.layers == 0 || !expected || header != *expected ||
+            header.file_size > m_length) {
+            close();
+            return false;
+        }
+        m_cols = header.cols;
+        m_rows = header.rows;
+        auto plane_words{header.words_per_row * header.rows};
+        for (std::size_t z = 0; z < header.layers; ++z) {
+            auto* words{reinterpret_cast<const uint64_t*>(static_cast<const std::byte*>(m_mapping) +
+                                                          maze_file::PAGE_SIZE + z * header.layer_stride)};
+            m_layers.push_back({WallGrid(BitPlane::view(m_cols, m_rows, words),
+                                         BitPlane::view(m_cols, m_rows, words + plane_words)),
+                                BitPlane::view(m_cols, m_rows, words + 2 * plane_words)});
+        }
+        return true;
+    }
+
+    void close() {
+        m_layers.clear();
+        if (m_mapping != MAP_FAILED) {
+            ::munmap(m_mapping, m_length);
+            m_mapping = MAP_FAILED;
+        }
+    }
+
+    std::size_t cols() const {
+        return m_cols;
+    }
+
+    std::size_t rows() const {
+        return m_rows;
+    }
+
+    std::size_t layers() const {
+        return m_layers.size();
+    }
+
+    std::size_t size() const {
+        return m_cols * m_rows * m_layers.size();
+    }
+
+    const Layer& layer(std::size_t z) const {
+        return m_layers[z];
+    }
+
+    bool has_wall(std::size_t col, std::size_t row, std::size_t z, Direction direction) const {
+        switch (direction) {
+            case Direction::Up:
+                return z + 1 >= m_layers.size() || m_layers[z].up.test(col, row);
+            case Direction::Down:
+                return z == 0 || m_layers[z - 1].up.test(col, row);
+            default:
+                return m_layers[z].walls.has_wall(col, row, direction);
+        }
+    }
+
+    // Breadth first search from `start` to `goal`, returns the number of steps between them or nothing if the goal
+    // can't be reached.
+    std::optional<std::size_t> distance(std::size_t start, std::size_t goal) const {
+        auto layer_size{m_cols * m_rows};
+        // one row per row of every layer, so the visited bits of a layer are contiguous as well
+        BitPlane visited(m_cols, m_rows * m_layers.size(), false);
+        std::vector<std::size_t> frontier{start};
+        std::vector<std::size_t> next;
+        visited.set(start % m_cols, start / m_cols);
+        for (std::size_t steps = 0; !frontier.empty(); ++steps) {
+            for (auto index : frontier) {
+                if (index == goal) {
+                    return steps;
+                }
+                auto col{index % m_cols};
+                auto row{index / m_cols % m_rows};
+                auto z{index / layer_size};
+                auto visit = [&](Direction direction, std::size_t neighbour) {
+                    if (!has_wall(col, row, z, direction) && !visited.test(neighbour % m_cols, neighbour / m_cols)) {
+                        visited.set(neighbour % m_cols, neighbour / m_cols);
+                        next.push_back(neighbour);
+                    }
+                };
+                visit(Direction::North, index - m_cols);
+                visit(Direction::East, index + 1);
+                visit(Direction::South, index + m_cols);
+                visit(Direction::West, index - 1);
+                visit(Direction::Up, index + layer_size);
+                visit(Direction::Down, index - layer_size);
+            }
+            frontier.swap(next);
+            next.clear();
+        }
+        return std::nullopt;
+    }
+
+  private:
+    std::size_t m_cols{0};
+    std::size_t m_rows{0};
+    std::vector<Layer> m_layers;
+    void* m_mapping{MAP_FAILED};
+    std::size_t m_length{0};
+};
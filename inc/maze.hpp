@@ -1,99 +1,1003 @@
+#pragma once
 
 #include "olcPixelGameEngine.h"
 
+#include "algorithm.hpp"
+#include "bucket_queue.hpp"
+#include "camera.hpp"
 #include "cell.hpp"
+#include "generator.hpp"
+#include "grid_search.hpp"
+#include "growing_tree.hpp"
+#include "maze_event.hpp"
+#include "random.hpp"
+#include "recursive_division.hpp"
+#include "row_carvers.hpp"
+#include "wall_grid.hpp"
+#include "wilson.hpp"
+#include "wrap.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
 #include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <optional>
 #include <ranges>
-#include <stack>
+#include <utility>
 #include <vector>
+
 class Maze {
   public:
-    Maze(std::size_t cols, std::size_t rows, std::size_t cell_width, std::size_t cell_height) :
-        m_cols(cols), m_rows(rows) {
-        m_grid.reserve(cols * rows);
-        for (std::size_t row : std::views::iota(std::size_t(0), m_rows)) {
-            for (std::size_t col : std::views::iota(std::size_t(0), m_cols)) {
-                m_grid.emplace_back(col, row, cell_width, cell_height);
-            }
-        }
-        cell_at(0, 0).set_visited();
-    }
-
-    void draw(olc::PixelGameEngine* pge) {
-        for (auto& cell : m_grid) {
-            cell.draw(pge);
-        }
-    }
-
-    void generate(olc::PixelGameEngine* pge) {
-        std::stack<Cell*> visitor;
-        visitor.push(&cell_at(0, 0));
-
-        while (!visitor.empty()) {
-            auto& current_cell = visitor.top();
-            current_cell->draw(pge, olc::GREEN);
-
-            auto unvisited_neighbours = get_unvisited_neighbours(current_cell->m_x, current_cell->m_y);
-            if (!unvisited_neighbours.empty()) {
-                auto [random_neighbour_direction, random_neighbour] =
-                    unvisited_neighbours.at(rand() % unvisited_neighbours.size());
-                random_neighbour.set_visited();
-                visitor.push(&random_neighbour);
-                switch (random_neighbour_direction) {
-                    case Direction::North: {
-                        random_neighbour.remove_wall(Direction::South);
-                        current_cell->remove_wall(Direction::North);
-                    } break;
-                    case Direction::East: {
-                        random_neighbour.remove_wall(Direction::West);
-                        current_cell->remove_wall(Direction::East);
-                    } break;
-                    case Direction::West: {
-                        random_neighbour.remove_wall(Direction::East);
-                        current_cell->remove_wall(Direction::West);
-                    } break;
-                    case Direction::South: {
-                        random_neighbour.remove_wall(Direction::North);
-                        current_cell->remove_wall(Direction::South);
-                    } break;
-                    default:
-                        break;
+    Maze(std::size_t cols, std::size_t rows, std::size_t cell_width, std::size_t cell_height, Wrap wrap = Wrap::None) :
+        m_cols(cols),
+        m_rows(rows),
+        m_cell_w(static_cast<int32_t>(cell_width)),
+        m_cell_h(static_cast<int32_t>(cell_height)),
+        m_walls(cols, rows),
+        m_visited(cols, rows, false) {
+        m_visited.set(0, 0);
+        set_wrap(wrap);
+    }
+
+    // Generation restricted to the cells set in `mask`, starting in the first of them. Masked out cells start as
+    // visited, so the generator treats them like the outer border and runs as fast as on a full rectangle. Parts of the
+    // mask not connected to the first cell stay closed.
+    Maze(BitPlane mask, std::size_t cell_width, std::size_t cell_height) :
+        m_cols(mask.cols()),
+        m_rows(mask.rows()),
+        m_cell_w(static_cast<int32_t>(cell_width)),
+        m_cell_h(static_cast<int32_t>(cell_height)),
+        m_walls(mask.cols(), mask.rows()),
+        m_visited(mask.cols(), mask.rows(), true),
+        m_mask(std::move(mask)) {
+        for (std::size_t word = 0; word < m_visited.word_count(); ++word) {
+            m_visited.data()[word] &= ~m_mask.data()[word];
+        }
+        m_start = first_allowed();
+        if (is_allowed(m_start)) {
+            m_visited.set(m_start % m_cols, m_start / m_cols);
+        }
+        set_wrap(Wrap::None);
+    }
+
+    // A finished maze over existing walls, e.g. a read only view of a mapped file. Every cell counts as visited.
+    Maze(WallGrid walls,
+         std::size_t cell_width,
+         std::size_t cell_height,
+         uint64_t seed,
+         Algorithm algorithm,
+         Wrap wrap = Wrap::None) :
+        m_cols(walls.cols()),
+        m_rows(walls.rows()),
+        m_cell_w(static_cast<int32_t>(cell_width)),
+        m_cell_h(static_cast<int32_t>(cell_height)),
+        m_walls(std::move(walls)),
+        m_seed(seed),
+        m_algorithm(algorithm) {
+        set_wrap(wrap);
+    }
+
+    std::size_t cols() const {
+        return m_cols;
+    }
+
+    std::size_t rows() const {
+        return m_rows;
+    }
+
+    std::size_t size() const {
+        return m_cols * m_rows;
+    }
+
+    uint64_t seed() const {
+        return m_seed;
+    }
+
+    Algorithm algorithm() const {
+        return m_algorithm;
+    }
+
+    Wrap wrap() const {
+        return m_wrap;
+    }
+
+    const WallGrid& walls() const {
+        return m_walls;
+    }
+
+    bool is_read_only() const {
+        return m_walls.is_view();
+    }
+
+    // Finished mazes, e.g. loaded ones, have no visited plane left.
+    bool is_generated() const {
+        return m_visited.empty();
+    }
+
+    // Bytes owned by this maze, walls of a mapped maze are not counted.
+    std::size_t memory_usage() const {
+        auto plane_bytes = [](const BitPlane& plane) {
+            return (plane.is_view()) ? 0 : plane.word_count() * sizeof(uint64_t);
+        };
+        auto lookup_bytes = [](const std::vector<std::size_t>& lookup) {
+            return lookup.capacity() * sizeof(std::size_t);
+        };
+        return plane_bytes(m_walls.east()) + plane_bytes(m_walls.south()) + plane_bytes(m_visited) +
+               plane_bytes(m_mask) + m_cost.capacity() + m_g_score.capacity() * sizeof(int32_t) +
+               lookup_bytes(m_west_col) + lookup_bytes(m_east_col) + lookup_bytes(m_north_row) +
+               lookup_bytes(m_south_row) + m_scratch.memory_usage();
+    }
+
+    // Peak bytes of scratch data the last generator held on top of the maze's planes, e.g. its stack or frontier.
+    std::size_t generation_scratch() const {
+        return m_generation_scratch;
+    }
+
+    // Drops the visited plane and the scratch of the generators and the solver of a finished maze, leaving only the
+    // walls.
+    void release_scratch() {
+        m_visited = BitPlane();
+        m_g_score = std::vector<int32_t>();
+        m_scratch = Scratch();
+    }
+
+    // Starts over as a maze of `cols` x `rows` with all walls standing, in the memory of the previous maze. Planes and
+    // scratch only grow, so once a maze was as large as the next one resetting and generating allocate nothing.
+    void reset(std::size_t cols, std::size_t rows, Wrap wrap = Wrap::None) {
+        m_cols = cols;
+        m_rows = rows;
+        m_walls.reshape(cols, rows);
+        m_visited.reshape(cols, rows, false);
+        m_visited.set(0, 0);
+        m_mask.reshape(0, 0, false);
+        m_start = 0;
+        m_seed = 0;
+        m_algorithm = Algorithm::Backtracker;
+        m_generation_scratch = 0;
+        m_cost.clear();
+        m_min_cost = 1;
+        m_max_cost = 1;
+        m_g_score.clear();
+        set_wrap(wrap);
+    }
+
+    bool has_wall(std::size_t index, Direction direction) const {
+        return wall_at(index % m_cols, index / m_cols, direction);
+    }
+
+    // Cell the generator starts in and the solver starts from.
+    std::size_t start() const {
+        return m_start;
+    }
+
+    bool is_masked() const {
+        return !m_mask.empty();
+    }
+
+    bool is_allowed(std::size_t index) const {
+        return m_mask.empty() || m_mask.test(index % m_cols, index / m_cols);
+    }
+
+    // Allowed cells connected to the start, the cells a generator growing from the start visits. Parts of a mask cut
+    // off from the start stay closed and are left out.
+    BitPlane reachable() const {
+        BitPlane reached(m_cols, m_rows, false);
+        if (!is_allowed(m_start)) {
+            return reached;
+        }
+        std::vector<std::size_t> stack{m_start};
+        reached.set(m_start % m_cols, m_start / m_cols);
+        while (!stack.empty()) {
+            auto current{stack.back()};
+            stack.pop_back();
+            for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+                auto neighbour{neighbour_index(current, direction)};
+                if (neighbour != NO_NEIGHBOUR && is_allowed(neighbour) &&
+                    !reached.test(neighbour % m_cols, neighbour / m_cols)) {
+                    reached.set(neighbour % m_cols, neighbour / m_cols);
+                    stack.push_back(neighbour);
+                }
+            }
+        }
+        return reached;
+    }
+
+    // Cost of stepping into every cell, from 1 to 255, in the order of the cells. An empty plane makes every step cost
+    // 1, a plane of the wrong size or with a cost of 0 is refused.
+    bool set_costs(std::vector<uint8_t> costs) {
+        if (!costs.empty() && (costs.size() != size() || std::ranges::find(costs, 0) != costs.end())) {
+            return false;
+        }
+        m_cost = std::move(costs);
+        m_min_cost = (m_cost.empty()) ? 1 : std::ranges::min(m_cost);
+        m_max_cost = (m_cost.empty()) ? 1 : std::ranges::max(m_cost);
+        return true;
+    }
+
+    int32_t cost(std::size_t index) const {
+        return (m_cost.empty()) ? 1 : m_cost[index];
+    }
+
+    // Sum of the costs along the path the last solve found to `index`, nothing if it wasn't reached.
+    std::optional<int32_t> path_cost(std::size_t index) const {
+        if (m_g_score.empty() || m_g_score[index] == UNREACHED) {
+            return std::nullopt;
+        }
+        return m_g_score[index];
+    }
+
+    bool is_visited(std::size_t index) const {
+        return m_visited.empty() || m_visited.test(index % m_cols, index / m_cols);
+    }
+
+    // Snapshot of a single cell for drawing.
+    Cell cell(std::size_t index) const {
+        auto col{index % m_cols};
+        auto row{index / m_cols};
+        Cell cell(static_cast<int32_t>(col), static_cast<int32_t>(row), m_cell_w, m_cell_h);
+        for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+            if (!wall_at(col, row, direction)) {
+                cell.remove_wall(direction);
+            }
+        }
+        if (is_visited(index)) {
+            cell.set_visited();
+        }
+        if (!m_g_score.empty()) {
+            cell.m_g_score = m_g_score[index];
+        }
+        return cell;
+    }
+
+    // Only draws the cells visible through the camera, in the overview every screen pixel is drawn exactly once.
+    void draw(olc::PixelGameEngine* pge, const Camera& camera) const {
+        auto range{camera.visible_cells(static_cast<int32_t>(m_cols), static_cast<int32_t>(m_rows))};
+        if (camera.is_overview()) {
+            for (int32_t y : std::views::iota(0, pge->ScreenHeight())) {
+                auto row{camera.row_at(y)};
+                if (row < range.first_row || row >= range.last_row) {
+                    continue;
                 }
+                for (int32_t x : std::views::iota(0, pge->ScreenWidth())) {
+                    auto col{camera.col_at(x)};
+                    if (col >= range.first_col && col < range.last_col) {
+                        auto cell{this->cell(index_from(row, col))};
+                        pge->Draw(x, y, cell.overview_color(cell_color(cell)));
+                    }
+                }
+            }
+            return;
+        }
+        for (int32_t row : std::views::iota(range.first_row, range.last_row)) {
+            for (int32_t col : std::views::iota(range.first_col, range.last_col)) {
+                auto cell{this->cell(index_from(row, col))};
+                cell.draw(pge, camera, cell_color(cell));
+            }
+        }
+    }
+
+    // Recursive backtracker from the start cell, yields every carved wall and every backtracked cell.
+    Generator<MazeEvent> generate(uint64_t seed) {
+        m_seed = seed;
+        m_algorithm = Algorithm::Backtracker;
+        m_generation_scratch = 0;
+        if (!is_allowed(m_start)) {
+            return {};
+        }
+        return GridSearch::backtrack(*this, seed, m_start, m_scratch.stack, m_generation_scratch);
+    }
+
+    // Growing tree from the start cell with `Policy` choosing the active cell to grow from, yields every carved wall
+    // and every cell leaving the active set as backtracked.
+    template <typename Policy>
+    Generator<MazeEvent> grow(uint64_t seed) {
+        m_seed = seed;
+        m_algorithm = Policy::ALGORITHM;
+        Random random(seed);
+        auto& active{m_scratch.active};
+        active.clear();
+        if (is_allowed(m_start)) {
+            active.push(m_start);
+        }
+
+        while (!active.empty()) {
+            auto position{Policy::pick(active.size(), random)};
+            auto current{active[position]};
+
+            auto unvisited_neighbours{unvisited_steps(current)};
+            if (unvisited_neighbours.count > 0) {
+                auto direction{unvisited_neighbours.steps[random.below(unvisited_neighbours.count)]};
+                auto neighbour{neighbour_index(current, direction)};
+                m_visited.set(neighbour % m_cols, neighbour / m_cols);
+                active.push(neighbour);
+                remove_wall(current % m_cols, current / m_cols, direction);
+                co_yield MazeEvent{MazeEvent::Kind::Carve, direction, static_cast<uint32_t>(current)};
             } else {
-                visitor.pop();
+                active.remove(position);
+                co_yield MazeEvent{MazeEvent::Kind::Backtrack, Direction::NUM, static_cast<uint32_t>(current)};
             }
+            m_generation_scratch = active.memory_usage();
         }
     }
 
+    // Hunt and kill from the start cell: walks to random unvisited neighbours until it is stuck, then hunts for an
+    // unvisited cell next to the maze, joins it to the maze and walks on from there. Yields every carved wall. Instead
+    // of a stack it only keeps a bit per row, see `hunt`.
+    Generator<MazeEvent> hunt_and_kill(uint64_t seed) {
+        m_seed = seed;
+        m_algorithm = Algorithm::HuntAndKill;
+        Random random(seed);
+        auto& pending_rows{m_scratch.pending_rows};
+        pending_rows.assign(BitPlane::words_per_row(m_rows), ~uint64_t(0));
+        std::size_t first_pending{0};
+        m_generation_scratch = pending_rows.size() * sizeof(uint64_t);
+        auto current{(is_allowed(m_start)) ? std::optional<std::size_t>(m_start) : std::nullopt};
+
+        while (current) {
+            auto unvisited_neighbours{unvisited_steps(*current)};
+            if (unvisited_neighbours.count > 0) {
+                auto direction{unvisited_neighbours.steps[random.below(unvisited_neighbours.count)]};
+                auto neighbour{neighbour_index(*current, direction)};
+                m_visited.set(neighbour % m_cols, neighbour / m_cols);
+                remove_wall(*current % m_cols, *current / m_cols, direction);
+                co_yield MazeEvent{MazeEvent::Kind::Carve, direction, static_cast<uint32_t>(*current)};
+                current = neighbour;
+                continue;
+            }
+
+            current = hunt(pending_rows, first_pending);
+            if (!current) {
+                break;
+            }
+            Neighbours joined;
+            for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+                if (is_in_maze(neighbour_index(*current, direction))) {
+                    joined.steps[joined.count++] = direction;
+                }
+            }
+            auto direction{joined.steps[random.below(joined.count)]};
+            auto neighbour{neighbour_index(*current, direction)};
+            m_visited.set(*current % m_cols, *current / m_cols);
+            remove_wall(*current % m_cols, *current / m_cols, direction);
+            // carved from the maze's side, so replaying it marks the hunted cell as visited
+            co_yield MazeEvent{MazeEvent::Kind::Carve, opposite(direction), static_cast<uint32_t>(neighbour)};
+        }
+    }
+
+    // Randomized Prim from the start cell: joins a random cell of the frontier, the unvisited cells next to the maze,
+    // to a random neighbour in the maze. The frontier is a dense vector of cells, picking a random cell swaps it with
+    // the last one and pops it in O(1), and a bit per cell tells whether a cell is in the frontier already. Yields
+    // every carved wall.
+    Generator<MazeEvent> prim(uint64_t seed) {
+        m_seed = seed;
+        m_algorithm = Algorithm::Prim;
+        Random random(seed);
+        auto& frontier{m_scratch.frontier};
+        auto& in_frontier{m_scratch.in_frontier};
+        frontier.clear();
+        in_frontier.reshape(m_cols, m_rows, false);
+        auto extend_frontier = [&](std::size_t index) {
+            auto unvisited_neighbours{unvisited_steps(index)};
+            for (std::size_t i = 0; i < unvisited_neighbours.count; ++i) {
+                auto neighbour{neighbour_index(index, unvisited_neighbours.steps[i])};
+                if (!in_frontier.test(neighbour % m_cols, neighbour / m_cols)) {
+                    in_frontier.set(neighbour % m_cols, neighbour / m_cols);
+                    frontier.push_back(static_cast<uint32_t>(neighbour));
+                }
+            }
+        };
+        if (is_allowed(m_start)) {
+            extend_frontier(m_start);
+        }
+
+        while (!frontier.empty()) {
+            auto position{random.below(frontier.size())};
+            std::size_t current{frontier[position]};
+            frontier[position] = frontier.back();
+            frontier.pop_back();
+
+            Neighbours joined;
+            for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+                if (is_in_maze(neighbour_index(current, direction))) {
+                    joined.steps[joined.count++] = direction;
+                }
+            }
+            auto direction{joined.steps[random.below(joined.count)]};
+            auto neighbour{neighbour_index(current, direction)};
+            m_visited.set(current % m_cols, current / m_cols);
+            remove_wall(current % m_cols, current / m_cols, direction);
+            extend_frontier(current);
+            // carved from the maze's side, so replaying it marks the joined cell as visited
+            co_yield MazeEvent{MazeEvent::Kind::Carve, opposite(direction), static_cast<uint32_t>(neighbour)};
+        }
+        m_generation_scratch = frontier.capacity() * sizeof(uint32_t) + in_frontier.word_count() * sizeof(uint64_t);
+    }
+
+    // Aldous-Broder: a random walk from the start cell which carves its way into every cell it enters for the first
+    // time, a uniform spanning tree but slow as it lasts until every cell was seen. Yields every carved wall. Within a
+    // mask the walk stays on the allowed cells and ends once it has seen those connected to the start.
+    Generator<MazeEvent> aldous_broder(uint64_t seed) {
+        m_seed = seed;
+        m_algorithm = Algorithm::AldousBroder;
+        m_generation_scratch = 0;
+        if (!is_allowed(m_start)) {
+            co_return;
+        }
+        std::size_t unvisited{size() - m_visited.count()};
+        if (!m_mask.empty()) {
+            auto reached{reachable()};
+            unvisited = 0;
+            for (std::size_t word = 0; word < reached.word_count(); ++word) {
+                unvisited += static_cast<std::size_t>(std::popcount(reached.data()[word] & ~m_visited.data()[word]));
+            }
+            m_generation_scratch = reached.word_count() * sizeof(uint64_t);
+        }
+        Random random(seed);
+        auto current{m_start};
+        while (unvisited > 0) {
+            Neighbours neighbours;
+            for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+                if (auto neighbour{neighbour_index(current, direction)};
+                    neighbour != NO_NEIGHBOUR && is_allowed(neighbour)) {
+                    neighbours.steps[neighbours.count++] = direction;
+                }
+            }
+            auto direction{neighbours.steps[random.below(neighbours.count)]};
+            auto neighbour{neighbour_index(current, direction)};
+            if (!m_visited.test(neighbour % m_cols, neighbour / m_cols)) {
+                m_visited.set(neighbour % m_cols, neighbour / m_cols);
+                remove_wall(current % m_cols, current / m_cols, direction);
+                --unvisited;
+                co_yield MazeEvent{MazeEvent::Kind::Carve, direction, static_cast<uint32_t>(current)};
+            }
+            current = neighbour;
+        }
+    }
+
+    // Uniform spanning tree with Wilson's algorithm as in `wilson.hpp`, the tree is grown aside on a single thread and
+    // then carved here row by row.
+    Generator<MazeEvent> generate_wilson(uint64_t seed) {
+        m_seed = seed;
+        m_algorithm = Algorithm::Wilson;
+        assert(size() <= wilson::MAX_CELLS);
+        auto& tree{m_scratch.walls};
+        tree.reshape(m_cols, m_rows);
+        wilson::carve(tree, wilson_grid(), m_start, seed, 1, m_scratch.wilson);
+        m_generation_scratch = (tree.east().word_count() + tree.south().word_count()) * sizeof(uint64_t) +
+                               m_scratch.wilson.memory_usage();
+        for (std::size_t row = 0; row < m_rows; ++row) {
+            for (auto& event : carve_like(tree, row)) {
+                co_yield event;
+            }
+        }
+    }
+
+    // Same walls as `generate_wilson` but carved in place by walkers on `threads` threads and without any events.
+    void wilson(uint64_t seed, std::size_t threads) {
+        assert(size() <= wilson::MAX_CELLS);
+        m_seed = seed;
+        m_algorithm = Algorithm::Wilson;
+        wilson::carve(m_walls, wilson_grid(), m_start, seed, threads, m_scratch.wilson);
+        m_generation_scratch = m_scratch.wilson.memory_usage();
+        for (std::size_t row = 0; row < m_rows; ++row) {
+            mark_visited(row);
+        }
+    }
+
+    // Carves one row after the other with binary tree or sidewinder, yields the carved walls of every row once the row
+    // is done.
+    Generator<MazeEvent> generate_rows(uint64_t seed, Algorithm algorithm) {
+        m_seed = seed;
+        m_algorithm = algorithm;
+        auto carve_row{row_carver_of(algorithm)};
+        for (std::size_t row = 0; row < m_rows; ++row) {
+            carve_row(m_walls, row, seed);
+            for (auto& event : carve_like(m_walls, row)) {
+                co_yield event;
+            }
+        }
+    }
+
+    // Recursive division adds walls instead of carving them, so the maze is divided aside and then carved here row by
+    // row to match.
+    Generator<MazeEvent> generate_divided(uint64_t seed) {
+        m_seed = seed;
+        m_algorithm = Algorithm::RecursiveDivision;
+        auto& divided{m_scratch.walls};
+        divided.reshape(m_cols, m_rows);
+        recursive_division::carve(divided, seed, 1);
+        m_generation_scratch = (divided.east().word_count() + divided.south().word_count()) * sizeof(uint64_t);
+        for (std::size_t row = 0; row < m_rows; ++row) {
+            for (auto& event : carve_like(divided, row)) {
+                co_yield event;
+            }
+        }
+    }
+
+    // Same walls as `generate_divided` but divided in place on `threads` threads and without any events.
+    void divide(uint64_t seed, std::size_t threads) {
+        m_seed = seed;
+        m_algorithm = Algorithm::RecursiveDivision;
+        recursive_division::carve(m_walls, seed, threads);
+        for (std::size_t row = 0; row < m_rows; ++row) {
+            mark_visited(row);
+        }
+    }
+
+    // Same walls as `generate_rows` but all at once on `threads` threads and without any events.
+    void carve_rows(uint64_t seed, Algorithm algorithm, std::size_t threads) {
+        m_seed = seed;
+        m_algorithm = algorithm;
+        row_carver::carve_rows(m_walls, seed, threads, row_carver_of(algorithm));
+        for (std::size_t row = 0; row < m_rows; ++row) {
+            mark_visited(row);
+        }
+    }
+
+    // A* from `start` to `goal` over the costs of the cells, see `GridSearch::solve`. Only the solver's scratch data
+    // is written, so read only mazes can be solved as well.
+    Generator<MazeEvent> solve(std::size_t start, std::size_t goal) {
+        return GridSearch::solve(*this, start, goal, m_g_score, m_scratch.came_from, m_scratch.open_set);
+    }
+
+    // Turns a perfect maze into one with loops by knocking a wall out of about `fraction` of the dead ends, preferring
+    // walls towards another dead end so both go at once. Yields every carved wall.
+    Generator<MazeEvent> braid(double fraction, uint64_t seed) {
+        Random random(seed);
+        auto& dead_ends{m_scratch.dead_ends};
+        dead_ends.clear();
+        for_each_dead_end([&](std::size_t index) { dead_ends.push_back(index); });
+        for (std::size_t i = dead_ends.size(); i > 1; --i) {
+            std::swap(dead_ends[i - 1], dead_ends[random.below(i)]);
+        }
+        auto kept{std::clamp(fraction, 0.0, 1.0) * static_cast<double>(dead_ends.size())};
+        dead_ends.resize(static_cast<std::size_t>(kept));
+
+        for (auto index : dead_ends) {
+            Neighbours closed;
+            Neighbours closed_dead_ends;
+            std::size_t walls{0};
+            for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+                if (!has_wall(index, direction)) {
+                    continue;
+                }
+                ++walls;
+                auto neighbour{neighbour_index(index, direction)};
+                if (neighbour == NO_NEIGHBOUR || !is_allowed(neighbour)) {
+                    continue;
+                }
+                closed.steps[closed.count++] = direction;
+                if (is_dead_end(neighbour)) {
+                    closed_dead_ends.steps[closed_dead_ends.count++] = direction;
+                }
+            }
+            // an earlier knock may already have opened this one
+            if (walls != 3 || closed.count == 0) {
+                continue;
+            }
+            const auto& candidates{(closed_dead_ends.count > 0) ? closed_dead_ends : closed};
+            auto direction{candidates.steps[random.below(candidates.count)]};
+            remove_wall(index % m_cols, index / m_cols, direction);
+            co_yield MazeEvent{MazeEvent::Kind::Carve, direction, static_cast<uint32_t>(index)};
+        }
+    }
+
+    std::size_t count_dead_ends() const {
+        std::size_t count{0};
+        for (std::size_t row = 0; row < m_rows; ++row) {
+            for (std::size_t word = 0; word < m_walls.east().words_per_row(); ++word) {
+                count += static_cast<std::size_t>(std::popcount(dead_end_word(row, word)));
+            }
+        }
+        return count;
+    }
+
+    // Replays recorded events onto this maze, the solver's scores are not part of a recording so the cells around an
+    // expanded cell are only marked as reached.
+    Generator<MazeEvent> replay(Generator<MazeEvent> events) {
+        for (auto& event : events) {
+            apply(event);
+            co_yield event;
+        }
+    }
+
+    void apply(const MazeEvent& event) {
+        switch (event.kind) {
+            case MazeEvent::Kind::Carve: {
+                auto neighbour{neighbour_index(event.index, event.direction)};
+                if (neighbour == NO_NEIGHBOUR) {
+                    break;
+                }
+                remove_wall(event.index % m_cols, event.index / m_cols, event.direction);
+                // generators carving whole rows mark their cells visited in bulk, so both ends of a carve count
+                m_visited.set(event.index % m_cols, event.index / m_cols);
+                m_visited.set(neighbour % m_cols, neighbour / m_cols);
+            } break;
+            case MazeEvent::Kind::Expand: {
+                if (m_g_score.empty()) {
+                    m_g_score.assign(size(), UNREACHED);
+                }
+                m_g_score[event.index] = std::min(m_g_score[event.index], 0);
+                for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+                    if (!has_wall(event.index, direction)) {
+                        auto neighbour{neighbour_index(event.index, direction)};
+                        m_g_score[neighbour] = std::min(m_g_score[neighbour], 0);
+                    }
+                }
+            } break;
+            default:
+                break;
+        }
+    }
+
+    // Cells already reached by the solver stay highlighted.
+    static olc::Pixel cell_color(const Cell& cell) {
+        return (cell.m_g_score != std::numeric_limits<int32_t>::max()) ? olc::MAGENTA : olc::WHITE;
+    }
+
+    // Neighbour in `direction`, `NO_NEIGHBOUR` beyond an edge which isn't joined.
+    std::size_t neighbour_index(std::size_t index, Direction direction) const {
+        return neighbour_at(index % m_cols, index / m_cols, direction);
+    }
+
+    constexpr static auto NO_NEIGHBOUR{std::numeric_limits<std::size_t>::max()};
+
   private:
-    Cell& cell_at(std::size_t row, std::size_t col) {
-        return m_grid.at(index_from(row, col));
+    friend struct GridSearch;
+    using Step = Direction;
+    using Event = MazeEvent;
+    using Neighbours = GridSearch::Steps<Direction, 4>;
+    constexpr static auto NO_STEP{Direction::NUM};
+
+    static MazeEvent event(MazeEvent::Kind kind, Direction direction, std::size_t index) {
+        return {kind, direction, static_cast<uint32_t>(index)};
+    }
+
+    static Direction opposite_step(Direction direction) {
+        return opposite(direction);
     }
 
-    std::vector<std::pair<Direction, Cell&>> get_unvisited_neighbours(std::size_t col, std::size_t row) {
-        std::vector<std::pair<Direction, Cell&>> neighbours;
-        if (row > 0 && !cell_at(row - 1, col).is_visited()) {
-            neighbours.emplace_back(Direction::North, cell_at(row - 1, col));
+    uint32_t cost_span() const {
+        return static_cast<uint32_t>(m_max_cost + m_min_cost);
+    }
+
+    // Directions without a wall.
+    Neighbours open_steps(std::size_t index) const {
+        Neighbours open;
+        for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+            if (!has_wall(index, direction)) {
+                open.steps[open.count++] = direction;
+            }
         }
-        if (col < m_cols - 1 && !cell_at(row, col + 1).is_visited()) {
-            neighbours.emplace_back(Direction::East, cell_at(row, col + 1));
+        return open;
+    }
+
+    // Carves into the neighbour in `direction`, which joins the maze.
+    void carve(std::size_t index, Direction direction) {
+        auto neighbour{neighbour_index(index, direction)};
+        m_visited.set(neighbour % m_cols, neighbour / m_cols);
+        remove_wall(index % m_cols, index / m_cols, direction);
+    }
+
+    Neighbours unvisited_steps(std::size_t index) const {
+        auto col{index % m_cols};
+        auto row{index / m_cols};
+        Neighbours neighbours;
+        if (auto north{m_north_row[row]}; north != NO_NEIGHBOUR && !m_visited.test(col, north)) {
+            neighbours.steps[neighbours.count++] = Direction::North;
         }
-        if (row < m_rows - 1 && !cell_at(row + 1, col).is_visited()) {
-            neighbours.emplace_back(Direction::South, cell_at(row + 1, col));
+        if (auto east{m_east_col[col]}; east != NO_NEIGHBOUR && !m_visited.test(east, row)) {
+            neighbours.steps[neighbours.count++] = Direction::East;
         }
-        if (col > 0 && !cell_at(row, col - 1).is_visited()) {
-            neighbours.emplace_back(Direction::West, cell_at(row, col - 1));
+        if (auto south{m_south_row[row]}; south != NO_NEIGHBOUR && !m_visited.test(col, south)) {
+            neighbours.steps[neighbours.count++] = Direction::South;
+        }
+        if (auto west{m_west_col[col]}; west != NO_NEIGHBOUR && !m_visited.test(west, row)) {
+            neighbours.steps[neighbours.count++] = Direction::West;
         }
 
         return neighbours;
     }
 
-    std::size_t index_from(std::size_t row, std::size_t col) {
+    // Visited cells inside the mask, those already part of the maze.
+    bool is_in_maze(std::size_t index) const {
+        return index != NO_NEIGHBOUR && is_allowed(index) && m_visited.test(index % m_cols, index / m_cols);
+    }
+
+    uint64_t in_maze_word(std::size_t row, std::size_t word) const {
+        auto visited{m_visited.row_words(row)[word]};
+        return (m_mask.empty()) ? visited : visited & m_mask.row_words(row)[word];
+    }
+
+    // Bit per cell of a word of a row, set for cells with a neighbour that is part of the maze.
+    uint64_t next_to_maze_word(std::size_t row, std::size_t word) const {
+        auto last_word{m_visited.words_per_row() - 1};
+        auto here{in_maze_word(row, word)};
+        auto result{(here << 1) | (here >> 1)};
+        if (m_north_row[row] != NO_NEIGHBOUR) {
+            result |= in_maze_word(m_north_row[row], word);
+        }
+        if (m_south_row[row] != NO_NEIGHBOUR) {
+            result |= in_maze_word(m_south_row[row], word);
+        }
+        if (word > 0) {
+            result |= in_maze_word(row, word - 1) >> (BitPlane::WORD_BITS - 1);
+        } else if (m_west_col[0] != NO_NEIGHBOUR) {
+            result |= uint64_t(is_in_maze(index_from(row, m_west_col[0])));
+        }
+        if (word < last_word) {
+            result |= in_maze_word(row, word + 1) << (BitPlane::WORD_BITS - 1);
+        } else if (m_east_col[m_cols - 1] != NO_NEIGHBOUR) {
+            auto east_of_last{uint64_t(is_in_maze(index_from(row, m_east_col[m_cols - 1])))};
+            result |= east_of_last << ((m_cols - 1) % BitPlane::WORD_BITS);
+        }
+        return result;
+    }
+
+    // First unvisited cell next to the maze, scanning the visited plane a word at a time. `pending_rows` has a bit per
+    // row, cleared once a hunt finds the row fully visited so later hunts skip it, and `first_pending` is the first of
+    // its words with a bit left. Rows above the first pending one are done, so a hunt mostly ends in its first row.
+    std::optional<std::size_t> hunt(std::vector<uint64_t>& pending_rows, std::size_t& first_pending) const {
+        for (; first_pending < pending_rows.size() && pending_rows[first_pending] == 0; ++first_pending) {
+        }
+        for (auto summary{first_pending}; summary < pending_rows.size(); ++summary) {
+            for (auto rows{pending_rows[summary]}; rows != 0; rows &= rows - 1) {
+                auto row{summary * BitPlane::WORD_BITS + static_cast<std::size_t>(std::countr_zero(rows))};
+                if (row >= m_rows) {
+                    return std::nullopt;
+                }
+                bool unvisited_left{false};
+                for (std::size_t word = 0; word < m_visited.words_per_row(); ++word) {
+                    auto valid{(word + 1 == m_visited.words_per_row()) ? m_visited.tail_mask() : ~uint64_t(0)};
+                    auto unvisited{~m_visited.row_words(row)[word] & valid};
+                    if (unvisited == 0) {
+                        continue;
+                    }
+                    unvisited_left = true;
+                    if (auto found{unvisited & next_to_maze_word(row, word)}; found != 0) {
+                        auto col{word * BitPlane::WORD_BITS + static_cast<std::size_t>(std::countr_zero(found))};
+                        return index_from(row, col);
+                    }
+                }
+                if (!unvisited_left) {
+                    pending_rows[summary] &= ~(uint64_t(1) << (row % BitPlane::WORD_BITS));
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Opens the north and east walls of a row which are open in `walls` as well, across joined edges too, and yields
+    // each of them.
+    Generator<MazeEvent> carve_like(const WallGrid& walls, std::size_t row) {
+        mark_visited(row);
+        for (std::size_t col = 0; col < m_cols; ++col) {
+            auto index{static_cast<uint32_t>(index_from(row, col))};
+            if (auto north{m_north_row[row]}; north != NO_NEIGHBOUR && !walls.south().test(col, north)) {
+                m_walls.south().reset(col, north);
+                co_yield MazeEvent{MazeEvent::Kind::Carve, Direction::North, index};
+            }
+            if (m_east_col[col] != NO_NEIGHBOUR && !walls.east().test(col, row)) {
+                m_walls.east().reset(col, row);
+                co_yield MazeEvent{MazeEvent::Kind::Carve, Direction::East, index};
+            }
+        }
+    }
+
+    wilson::Grid wilson_grid() const {
+        return {m_cols, m_rows, m_wrap != Wrap::None, m_wrap == Wrap::Torus};
+    }
+
+    static row_carver::CarveRow row_carver_of(Algorithm algorithm) {
+        return (algorithm == Algorithm::Sidewinder) ? row_carver::sidewinder : row_carver::binary_tree;
+    }
+
+    void mark_visited(std::size_t row) {
+        if (!m_visited.empty()) {
+            std::fill_n(m_visited.row_words(row), m_visited.words_per_row(), ~uint64_t(0));
+            m_visited.row_words(row)[m_visited.words_per_row() - 1] &= m_visited.tail_mask();
+        }
+    }
+
+    // Neighbouring columns and rows across every edge, looked up instead of computed so joined edges cost no modulo.
+    void set_wrap(Wrap wrap) {
+        m_wrap = wrap;
+        auto across = [](std::size_t count,
+                         bool joined,
+                         std::vector<std::size_t>& before,
+                         std::vector<std::size_t>& after) {
+            before.resize(count);
+            after.resize(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                before[i] = (i > 0) ? i - 1 : ((joined) ? count - 1 : NO_NEIGHBOUR);
+                after[i] = (i + 1 < count) ? i + 1 : ((joined) ? 0 : NO_NEIGHBOUR);
+            }
+        };
+        across(m_cols, wrap != Wrap::None, m_west_col, m_east_col);
+        across(m_rows, wrap == Wrap::Torus, m_north_row, m_south_row);
+    }
+
+    std::size_t neighbour_at(std::size_t col, std::size_t row, Direction direction) const {
+        auto at = [&](std::size_t neighbour_col, std::size_t neighbour_row) {
+            if (neighbour_col == NO_NEIGHBOUR || neighbour_row == NO_NEIGHBOUR) {
+                return NO_NEIGHBOUR;
+            }
+            return index_from(neighbour_row, neighbour_col);
+        };
+        switch (direction) {
+            case Direction::North:
+                return at(col, m_north_row[row]);
+            case Direction::East:
+                return at(m_east_col[col], row);
+            case Direction::South:
+                return at(col, m_south_row[row]);
+            case Direction::West:
+                return at(m_west_col[col], row);
+            default:
+                return NO_NEIGHBOUR;
+        }
+    }
+
+    // Every cell owns its east and south wall, across a joined edge these are the walls of the last column and row.
+    bool wall_at(std::size_t col, std::size_t row, Direction direction) const {
+        switch (direction) {
+            case Direction::North:
+                return m_north_row[row] == NO_NEIGHBOUR || m_walls.south().test(col, m_north_row[row]);
+            case Direction::East:
+                return m_east_col[col] == NO_NEIGHBOUR || m_walls.east().test(col, row);
+            case Direction::South:
+                return m_south_row[row] == NO_NEIGHBOUR || m_walls.south().test(col, row);
+            case Direction::West:
+                return m_west_col[col] == NO_NEIGHBOUR || m_walls.east().test(m_west_col[col], row);
+            default:
+                return true;
+        }
+    }
+
+    // Removes the wall towards the neighbour in `direction`, which has to exist.
+    void remove_wall(std::size_t col, std::size_t row, Direction direction) {
+        switch (direction) {
+            case Direction::North:
+                m_walls.south().reset(col, m_north_row[row]);
+                break;
+            case Direction::East:
+                m_walls.east().reset(col, row);
+                break;
+            case Direction::South:
+                m_walls.south().reset(col, row);
+                break;
+            case Direction::West:
+                m_walls.east().reset(m_west_col[col], row);
+                break;
+            default:
+                break;
+        }
+    }
+
+    bool is_dead_end(std::size_t index) const {
+        auto col{index % m_cols};
+        return (dead_end_word(index / m_cols, col / BitPlane::WORD_BITS) >> (col % BitPlane::WORD_BITS)) & 1;
+    }
+
+    // Bit per cell of a word of a row, set for cells with exactly three walls. The four walls of 64 cells are gathered
+    // from the planes with a few shifts and summed bit sliced, so the sweep costs a handful of operations per word.
+    uint64_t dead_end_word(std::size_t row, std::size_t word) const {
+        const auto& east_plane{m_walls.east()};
+        const auto& south_plane{m_walls.south()};
+        auto east{east_plane.row_words(row)[word]};
+        auto south{south_plane.row_words(row)[word]};
+        auto north_row{m_north_row[row]};
+        auto north{(north_row == NO_NEIGHBOUR) ? ~uint64_t(0) : south_plane.row_words(north_row)[word]};
+        uint64_t west_of_first{1};
+        if (word > 0) {
+            west_of_first = east_plane.row_words(row)[word - 1] >> (BitPlane::WORD_BITS - 1);
+        } else if (m_west_col[0] != NO_NEIGHBOUR) {
+            west_of_first = east_plane.test(m_west_col[0], row);
+        }
+        auto west{(east << 1) | west_of_first};
+
+        // two bit wide sums of the four walls, then three of four
+        auto sum_low{north ^ east ^ south ^ west};
+        auto carry_north_east{north & east};
+        auto carry_south_west{south & west};
+        auto carry_sums{(north ^ east) & (south ^ west)};
+        auto sum_high{carry_north_east ^ carry_south_west ^ carry_sums};
+        auto four{carry_north_east & carry_south_west};
+        auto valid{(word + 1 == east_plane.words_per_row()) ? east_plane.tail_mask() : ~uint64_t(0)};
+        return sum_low & sum_high & ~four & valid;
+    }
+
+    template <typename Visit>
+    void for_each_dead_end(Visit&& visit) const {
+        for (std::size_t row = 0; row < m_rows; ++row) {
+            for (std::size_t word = 0; word < m_walls.east().words_per_row(); ++word) {
+                for (auto bits{dead_end_word(row, word)}; bits != 0; bits &= bits - 1) {
+                    auto col{word * BitPlane::WORD_BITS + static_cast<std::size_t>(std::countr_zero(bits))};
+                    visit(row * m_cols + col);
+                }
+            }
+        }
+    }
+
+    std::size_t first_allowed() const {
+        for (std::size_t word = 0; word < m_mask.word_count(); ++word) {
+            if (auto bits{m_mask.data()[word]}; bits != 0) {
+                return word / m_mask.words_per_row() * m_cols +
+                       word % m_mask.words_per_row() * BitPlane::WORD_BITS +
+                       static_cast<std::size_t>(std::countr_zero(bits));
+            }
+        }
+        return 0;
+    }
+
+    std::size_t index_from(std::size_t row, std::size_t col) const {
         return col + row * m_cols;
     }
 
+    // Manhattan distance times the smallest cost, across a joined edge the shorter way around.
+    int32_t heuristic(std::size_t index, std::size_t goal) const {
+        auto distance = [](std::size_t a, std::size_t b, std::size_t count, bool joined) {
+            auto direct{(a > b) ? a - b : b - a};
+            return static_cast<int32_t>((joined) ? std::min(direct, count - direct) : direct);
+        };
+        return (distance(index % m_cols, goal % m_cols, m_cols, m_wrap != Wrap::None) +
+                distance(index / m_cols, goal / m_cols, m_rows, m_wrap == Wrap::Torus)) *
+               m_min_cost;
+    }
+
   private:
+    constexpr static auto UNREACHED{GridSearch::UNREACHED};
+
+    // Scratch data of the generators and the solver, kept from one maze to the next so a reset maze reuses it.
+    struct Scratch {
+        std::vector<std::size_t> stack;
+        growing_tree::ActiveSet active;
+        std::vector<uint64_t> pending_rows;
+        std::vector<uint32_t> frontier;
+        BitPlane in_frontier;
+        // walls built aside and then carved into the maze
+        WallGrid walls;
+        std::vector<std::size_t> dead_ends;
+        std::vector<Direction> came_from;
+        BucketQueue open_set;
+        wilson::State wilson;
+
+        std::size_t memory_usage() const {
+            auto plane_bytes = [](const BitPlane& plane) { return plane.word_count() * sizeof(uint64_t); };
+            return (stack.capacity() + dead_ends.capacity()) * sizeof(std::size_t) + active.memory_usage() +
+                   pending_rows.capacity() * sizeof(uint64_t) + frontier.capacity() * sizeof(uint32_t) +
+                   plane_bytes(in_frontier) + plane_bytes(walls.east()) + plane_bytes(walls.south()) +
+                   came_from.capacity() * sizeof(Direction) + open_set.memory_usage() + wilson.memory_usage();
+        }
+    };
+
     std::size_t m_cols;
     std::size_t m_rows;
-    std::vector<Cell> m_grid;
+    int32_t m_cell_w;
+    int32_t m_cell_h;
+
+    WallGrid m_walls;
+    BitPlane m_visited;
+    // cells taking part in the maze, empty for the full rectangle
+    BitPlane m_mask;
+    std::size_t m_start{0};
+    uint64_t m_seed{0};
+    Algorithm m_algorithm{Algorithm::Backtracker};
+    Wrap m_wrap{Wrap::None};
+    std::size_t m_generation_scratch{0};
+    std::vector<std::size_t> m_west_col;
+    std::vector<std::size_t> m_east_col;
+    std::vector<std::size_t> m_north_row;
+    std::vector<std::size_t> m_south_row;
+
+    // cost of stepping into each cell, empty when every step costs 1
+    std::vector<uint8_t> m_cost;
+    int32_t m_min_cost{1};
+    int32_t m_max_cost{1};
+
+    // solver scratch, also used to highlight reached cells
+    std::vector<int32_t> m_g_score;
+    Scratch m_scratch;
 };
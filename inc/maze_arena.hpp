@@ -0,0 +1,49 @@
+#pragma once
+
+#include "algorithm.hpp"
+#include "generators.hpp"
+#include "maze.hpp"
+#include <cstdint>
+#include <optional>
+
+// Generates and solves one maze after the other in the same memory, for batch jobs over many small mazes. The maze's
+// planes and the scratch of its generators and solver are reset instead of rebuilt and the coroutine frames come from
+// the frame pool, so once the arena has run each algorithm on its largest maze a maze costs no allocation at all.
+class MazeArena {
+  public:
+    MazeArena(std::size_t cell_width, std::size_t cell_height) : m_maze(1, 1, cell_width, cell_height) {};
+
+    // The maze of the last `reset` or `generate`.
+    const Maze& maze() const {
+        return m_maze;
+    }
+
+    // Starts a new maze with all walls standing, e.g. to replay events onto.
+    Maze& reset(std::size_t cols, std::size_t rows, Wrap wrap = Wrap::None) {
+        m_maze.reset(cols, rows, wrap);
+        return m_maze;
+    }
+
+    // Starts a new maze and runs `algorithm` on it to the end, every generator supports the full rectangle.
+    const Maze& generate(std::size_t cols,
+                         std::size_t rows,
+                         uint64_t seed,
+                         Algorithm algorithm = Algorithm::Backtracker,
+                         Wrap wrap = Wrap::None) {
+        m_maze.reset(cols, rows, wrap);
+        auto events{generators::generate(m_maze, seed, algorithm)};
+        for ([[maybe_unused]] auto& event : *events) {
+        }
+        return m_maze;
+    }
+
+    // Solves the current maze from its start to `goal`, the cost of the path if there is one.
+    std::optional<int32_t> solve(std::size_t goal) {
+        for ([[maybe_unused]] auto& event : m_maze.solve(m_maze.start(), goal)) {
+        }
+        return m_maze.path_cost(goal);
+    }
+
+  private:
+    Maze m_maze;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "generators.hpp"
+#include "maze.hpp"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+// Fully identifies a maze, generating with the same descriptor always produces the same walls.
+struct MazeDescriptor {
+    Algorithm algorithm{Algorithm::Backtracker};
+    uint32_t cols{0};
+    uint32_t rows{0};
+    uint64_t seed{0};
+    Wrap wrap{Wrap::None};
+
+    bool operator==(const MazeDescriptor&) const = default;
+};
+
+template <>
+struct std::hash<MazeDescriptor> {
+    std::size_t operator()(const MazeDescriptor& descriptor) const noexcept {
+        auto value{descriptor.seed * 0x9E3779B97F4A7C15};
+        value ^= (static_cast<uint64_t>(descriptor.cols) << 32 | descriptor.rows) + 0x632BE59BD9B4E019 + (value << 6);
+        value ^= std::to_underlying(descriptor.algorithm) + (value >> 2);
+        value ^= std::to_underlying(descriptor.wrap) + (value << 6);
+        return static_cast<std::size_t>(value);
+    }
+};
+
+inline MazeDescriptor describe(const Maze& maze) {
+    return {maze.algorithm(),
+            static_cast<uint32_t>(maze.cols()),
+            static_cast<uint32_t>(maze.rows()),
+            maze.seed(),
+            maze.wrap()};
+}
+
+inline std::unique_ptr<Maze> materialize(const MazeDescriptor& descriptor,
+                                         std::size_t cell_width,
+                                         std::size_t cell_height) {
+    auto maze{std::make_unique<Maze>(descriptor.cols, descriptor.rows, cell_width, cell_height, descriptor.wrap)};
+    auto events{generators::generate(*maze, descriptor.seed, descriptor.algorithm)};
+    for ([[maybe_unused]] auto& event : *events) {
+    }
+    maze->release_scratch();
+    return maze;
+}
+
+// Keeps recently used mazes materialized and regenerates the others on demand. Once the owned memory exceeds the limit
+// the least recently used mazes are evicted, mazes still referenced by a caller stay alive until released.
+// Not thread safe.
+class MazeCache {
+    struct Entry {
+        MazeDescriptor descriptor;
+        std::shared_ptr<const Maze> maze;
+        std::size_t bytes;
+    };
+
+  public:
+    MazeCache(std::size_t memory_limit, std::size_t cell_width, std::size_t cell_height) :
+        m_memory_limit(memory_limit), m_cell_w(cell_width), m_cell_h(cell_height) {};
+
+    std::shared_ptr<const Maze> get(const MazeDescriptor& descriptor) {
+        if (auto it{m_index.find(descriptor)}; it != m_index.end()) {
+            ++m_hits;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->maze;
+        }
+
+        ++m_misses;
+        std::shared_ptr<const Maze> maze{materialize(descriptor, m_cell_w, m_cell_h)};
+        auto bytes{maze->memory_usage()};
+        m_entries.push_front({descriptor, maze, bytes});
+        m_index.emplace(descriptor, m_entries.begin());
+        m_memory_usage += bytes;
+        evict();
+        return maze;
+    }
+
+    bool contains(const MazeDescriptor& descriptor) const {
+        return m_index.contains(descriptor);
+    }
+
+    std::size_t memory_usage() const {
+        return m_memory_usage;
+    }
+
+    std::size_t size() const {
+        return m_entries.size();
+    }
+
+    std::size_t hits() const {
+        return m_hits;
+    }
+
+    std::size_t misses() const {
+        return m_misses;
+    }
+
+    std::size_t evictions() const {
+        return m_evictions;
+    }
+
+  private:
+    // The most recently used maze is always kept, even if it alone exceeds the limit.
+    void evict() {
+        while (m_memory_usage > m_memory_limit && m_entries.size() > 1) {
+            auto& entry{m_entries.back()};
+            m_memory_usage -= entry.bytes;
+            m_index.erase(entry.descriptor);
+            m_entries.pop_back();
+            ++m_evictions;
+        }
+    }
+
+    std::size_t m_memory_limit;
+    std::size_t m_cell_w;
+    std::size_t m_cell_h;
+
+    std::list<Entry> m_entries; // most recently used first
+    std::unordered_map<MazeDescriptor, std::list<Entry>::iterator> m_index;
+    std::size_t m_memory_usage{0};
+
+    std::size_t m_hits{0};
+    std::size_t m_misses{0};
+    std::size_t m_evictions{0};
+};
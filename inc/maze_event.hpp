@@ -0,0 +1,18 @@
+#pragma once
+
+#include "direction.hpp"
+#include <cstdint>
+
+// A single step of a generation or solving algorithm.
+struct MazeEvent {
+    enum class Kind : uint8_t {
+        Carve,     // wall between `index` and its neighbour in `direction` removed, the neighbour is visited next
+        Backtrack, // `index` has no unvisited neighbours left and is removed from the stack
+        Expand,    // solver took `index` from the open set and scored its neighbours
+        Path,      // `index` is on the solution path, its predecessor lies in `direction`
+    };
+
+    Kind kind{Kind::Carve};
+    Direction direction{Direction::NUM};
+    uint32_t index{0};
+};
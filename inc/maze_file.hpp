@@ -0,0 +1,171 @@
+#pragma once
+
+#include "bit_plane.hpp"
+#include "maze.hpp"
+#include "wall_grid.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Binary maze file: a header in the first page followed by the east and south wall bitplanes, each starting on a page
+// boundary with rows padded to whole 64 bit words exactly as in `BitPlane`. All values are little endian, so the
+// planes can be used straight from a read only memory mapping.
+namespace maze_file {
+constexpr static std::array<char, 4> MAGIC{'M', 'A', 'Z', 'E'};
+constexpr static uint16_t VERSION{1};
+constexpr static uint64_t PAGE_SIZE{4096};
+
+static_assert(std::endian::native == std::endian::little, "maze files are mapped without byte swapping");
+
+struct Header {
+    std::array<char, 4> magic;
+    uint16_t version;
+    uint8_t algorithm;
+    uint8_t wrap;
+    uint32_t cols;
+    uint32_t rows;
+    uint64_t seed;
+    uint64_t words_per_row;
+    uint64_t east_offset;
+    uint64_t south_offset;
+    uint64_t file_size;
+};
+static_assert(sizeof(Header) == 56);
+
+constexpr uint64_t align_to_page(uint64_t offset) {
+    return (offset + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+}
+
+inline Header make_header(const Maze& maze) {
+    auto words_per_row{static_cast<uint64_t>(BitPlane::words_per_row(maze.cols()))};
+    auto plane_bytes{words_per_row * maze.rows() * sizeof(uint64_t)};
+    Header header{MAGIC,
+                  VERSION,
+                  std::to_underlying(maze.algorithm()),
+                  std::to_underlying(maze.wrap()),
+                  static_cast<uint32_t>(maze.cols()),
+                  static_cast<uint32_t>(maze.rows()),
+                  maze.seed(),
+                  words_per_row,
+                  PAGE_SIZE,
+                  align_to_page(PAGE_SIZE + plane_bytes),
+                  0};
+    header.file_size = header.south_offset + plane_bytes;
+    return header;
+}
+} // namespace maze_file
+
+inline bool save_maze(const Maze& maze, const std::string& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    auto header{maze_file::make_header(maze)};
+    auto write_plane = [&](const BitPlane& plane, uint64_t offset) {
+        std::string padding(offset - static_cast<uint64_t>(file.tellp()), '\0');
+        file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        file.write(reinterpret_cast<const char*>(plane.data()),
+                   static_cast<std::streamsize>(plane.word_count() * sizeof(uint64_t)));
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_plane(maze.walls().east(), header.east_offset);
+    write_plane(maze.walls().south(), header.south_offset);
+    return static_cast<bool>(file);
+}
+
+// Read only maze backed by a shared memory mapping of a maze file. Opening only validates the header, the pages are
+// loaded on first access and shared with every other process mapping the same file.
+class MappedMaze {
+  public:
+    MappedMaze() = default;
+    MappedMaze(const MappedMaze&) = delete;
+    MappedMaze& operator=(const MappedMaze&) = delete;
+
+    ~MappedMaze() {
+        close();
+    }
+
+    bool open(const std::string& path, std::size_t cell_width, std::size_t cell_height) {
+        close();
+        int fd{::open(path.c_str(), O_RDONLY)};
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status {};
+        if (::fstat(fd, &status) != 0 || static_cast<uint64_t>(status.st_size) < sizeof(maze_file::Header)) {
+            ::close(fd);
+            return false;
+        }
+        m_length = static_cast<std::size_t>(status.st_size);
+        m_mapping = ::mmap(nullptr, m_length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (m_mapping == MAP_FAILED) {
+            return false;
+        }
+
+        maze_file::Header header{};
+        std::memcpy(&header, m_mapping, sizeof(header));
+        if (!is_valid(header)) {
+            close();
+            return false;
+        }
+        auto* base{static_cast<const std::byte*>(m_mapping)};
+        auto plane = [&](uint64_t offset) {
+            return BitPlane::view(header.cols, header.rows, reinterpret_cast<const uint64_t*>(base + offset));
+        };
+        m_maze.emplace(WallGrid(plane(header.east_offset), plane(header.south_offset)),
+                       cell_width,
+                       cell_height,
+                       header.seed,
+                       static_cast<Algorithm>(header.algorithm),
+                       static_cast<Wrap>(header.wrap));
+        return true;
+    }
+
+    Maze& maze() {
+        return *m_maze;
+    }
+
+    void close() {
+        m_maze.reset();
+        if (m_mapping != MAP_FAILED) {
+            ::munmap(m_mapping, m_length);
+            m_mapping = MAP_FAILED;
+        }
+    }
+
+  private:
+    bool is_valid(const maze_file::Header& header) const {
+        if (header.magic != maze_file::MAGIC || header.version != maze_file::VERSION ||
+            header.algorithm > std::to_underlying(LAST_ALGORITHM) || header.wrap > std::to_underlying(Wrap::Torus) ||
+            header.cols == 0 || header.rows == 0 || header.words_per_row != BitPlane::words_per_row(header.cols)) {
+            return false;
+        }
+        // the offsets are read from the file, so their sums with the plane size are checked for overflow before they
+        // are compared with the length of the mapping
+        uint64_t plane_bytes{0};
+        uint64_t east_end{0};
+        uint64_t south_end{0};
+        if (__builtin_mul_overflow(header.words_per_row * sizeof(uint64_t), header.rows, &plane_bytes) ||
+            __builtin_add_overflow(header.east_offset, plane_bytes, &east_end) ||
+            __builtin_add_overflow(header.south_offset, plane_bytes, &south_end)) {
+            return false;
+        }
+        auto aligned = [](uint64_t offset) { return offset % maze_file::PAGE_SIZE == 0; };
+        return aligned(header.east_offset) && aligned(header.south_offset) &&
+               header.east_offset >= maze_file::PAGE_SIZE && east_end <= header.south_offset && south_end <= m_length;
+    }
+
+    void* m_mapping{MAP_FAILED};
+    std::size_t m_length{0};
+    std::optional<Maze> m_maze;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "olcPixelGameEngine.h"
+
+#include "camera.hpp"
+#include "maze.hpp"
+#include "maze_event.hpp"
+#include "tile.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <ranges>
+
+// CPU side copy of the rendered maze, painted once and afterwards only the tiles of changed cells are repainted.
+// Drawing it is a single sprite blit of the visible part, independent of the number of cells.
+class MazeSprite {
+    constexpr static auto WALL_WIDTH{1};
+
+  public:
+    // Mazes above this many pixels are drawn cell by cell instead.
+    constexpr static std::size_t MAX_PIXELS{std::size_t(1) << 26};
+
+    MazeSprite(const Maze& maze, int32_t cell_width, int32_t cell_height) :
+        m_maze(maze),
+        m_cell_w(cell_width),
+        m_cell_h(cell_height),
+        m_sprite(static_cast<int32_t>(maze.cols()) * (cell_width + WALL_WIDTH),
+                 static_cast<int32_t>(maze.rows()) * (cell_height + WALL_WIDTH)),
+        m_dirty(maze.size()) {
+        for (std::size_t index : std::views::iota(std::size_t(0), maze.size())) {
+            paint(index);
+        }
+    }
+
+    static bool fits(const Maze& maze, int32_t cell_width, int32_t cell_height) {
+        return maze.cols() * static_cast<std::size_t>(cell_width + WALL_WIDTH) * maze.rows() *
+                   static_cast<std::size_t>(cell_height + WALL_WIDTH) <=
+               MAX_PIXELS;
+    }
+
+    void apply(const MazeEvent& event) {
+        m_dirty.mark(m_maze, event);
+    }
+
+    // Repaints the tiles of all cells changed since the last update.
+    void update() {
+        m_dirty.drain([&](std::size_t index) { paint(index); });
+    }
+
+    // Blits the part of the sprite visible through the camera, only valid outside of the overview mode.
+    void draw(olc::PixelGameEngine* pge, const Camera& camera) {
+        auto scale{camera.scale()};
+        auto [origin_x, origin_y] = camera.to_screen(0, 0);
+        auto first_x{std::clamp(-origin_x / scale, 0, m_sprite.width)};
+        auto first_y{std::clamp(-origin_y / scale, 0, m_sprite.height)};
+        auto last_x{std::clamp((pge->ScreenWidth() - origin_x) / scale + 1, 0, m_sprite.width)};
+        auto last_y{std::clamp((pge->ScreenHeight() - origin_y) / scale + 1, 0, m_sprite.height)};
+        if (first_x >= last_x || first_y >= last_y) {
+            return;
+        }
+        pge->DrawPartialSprite(origin_x + first_x * scale,
+                               origin_y + first_y * scale,
+                               &m_sprite,
+                               first_x,
+                               first_y,
+                               last_x - first_x,
+                               last_y - first_y,
+                               static_cast<uint32_t>(scale));
+    }
+
+  private:
+    void paint(std::size_t index) {
+        auto cell{m_maze.cell(index)};
+        auto colors{tile_colors(cell, Maze::cell_color(cell))};
+        auto x0{static_cast<std::size_t>(cell.m_x) * static_cast<std::size_t>(m_cell_w + WALL_WIDTH)};
+        auto y0{static_cast<std::size_t>(cell.m_y) * static_cast<std::size_t>(m_cell_h + WALL_WIDTH)};
+        auto stride{static_cast<std::size_t>(m_sprite.width)};
+        paint_tile(m_sprite.GetData() + y0 * stride + x0,
+                   stride,
+                   static_cast<std::size_t>(m_cell_w),
+                   static_cast<std::size_t>(m_cell_h),
+                   colors.inside,
+                   colors.east,
+                   colors.south,
+                   colors.corner);
+    }
+
+    const Maze& m_maze;
+    int32_t m_cell_w;
+    int32_t m_cell_h;
+    olc::Sprite m_sprite;
+    DirtyCells m_dirty;
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "generators.hpp"
+#include "maze.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+struct Options {
+    int32_t cols{30};
+    int32_t rows{20};
+    int32_t steps_per_frame{1};
+    bool headless{false};
+    bool bench{false};
+    Algorithm algorithm{Algorithm::Backtracker};
+    int32_t threads{static_cast<int32_t>(std::max(1U, std::thread::hardware_concurrency()))};
+    std::string record_path;
+    std::string replay_path;
+    int32_t dump_every{0};
+    std::string dump_path{"-"};
+    uint64_t seed{0};
+    bool has_seed{false};
+    std::string save_path;
+    std::string load_path;
+    std::string save_chunked_path;
+    std::string load_chunked_path;
+    std::string text_path;
+    bool unicode{false};
+    std::string svg_path;
+    std::string png_path;
+    int32_t png_pitch{11};
+    std::string mask_path;
+    std::string costs_path;
+    std::string topology{"square"};
+    Wrap wrap{Wrap::None};
+    double braid{0.0};
+    int32_t layers{0};
+    std::string layers_path;
+};
+
+inline void print_usage(std::string_view program) {
+    std::cerr << "usage: " << program << " [options]\n"
+              << "  --cols N        maze width in cells\n"
+              << "  --rows N        maze height in cells\n"
+              << "  --steps N       algorithm steps per frame\n"
+              << "  --headless      run the algorithms at full speed without a window\n"
+              << "  --algorithm A   generator, backtracker by default:\n";
+    std::string names(17, ' ');
+    for (const auto& entry : generators::ENTRIES) {
+        if (names.size() + entry.name.size() >= 100) {
+            std::cerr << names << "\n";
+            names.assign(17, ' ');
+        }
+        names.append(" ").append(entry.name);
+    }
+    std::cerr << names << "\n"
+              << "  --threads N     threads of the parallel generators in the benchmark, all cores by default\n"
+              << "  --bench         time every generator on a maze of the given size\n"
+              << "  --record FILE   record all generation and solving events\n"
+              << "  --replay FILE   replay recorded events instead of running the algorithms\n"
+              << "  --dump-frames N write every N-th step as a Y4M video frame, implies --headless\n"
+              << "  --dump-output F destination of the Y4M stream, defaults to stdout (-)\n"
+              << "  --seed N        seed of the generator, random by default\n"
+              << "  --save FILE     save the generated maze\n"
+              << "  --load FILE     map a saved maze read only and solve it\n"
+              << "  --save-chunked FILE\n"
+              << "                  save the generated maze as compressed chunks\n"
+              << "  --load-chunked FILE\n"
+              << "                  decompress a chunked maze and solve it\n"
+              << "  --export-text F write the generated maze as text, - for stdout\n"
+              << "  --unicode       use box drawing characters for the text export\n"
+              << "  --export-svg F  write the generated maze as SVG with merged walls\n"
+              << "  --import-png F  read the walls from an image and solve it\n"
+              << "  --png-pitch N   pixels from one wall line to the next in the image, defaults to 11\n"
+              << "  --mask FILE     generate only within the dark pixels of an image, one pixel per cell\n"
+              << "  --costs FILE    step costs from an image, one pixel per cell, brighter cells cost more\n"
+              << "  --topology T    square, hex or triangle cells, the latter two run headless only\n"
+              << "  --braid F       knock a wall out of the fraction F of dead ends after generating\n"
+              << "  --wrap W        none, cylinder or torus, joins opposite edges of the maze\n"
+              << "  --layers N      generate and solve a maze of N stacked layers headless\n"
+              << "  --save-layers F stream the layers to a file while generating and solve it mapped\n";
+}
+
+inline std::optional<int32_t> parse_number(std::string_view text) {
+    int32_t value{};
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end != text.data() + text.size() || value <= 0) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+inline std::optional<Options> parse_options(int argc, char const* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        if (arg == "--headless") {
+            options.headless = true;
+            continue;
+        }
+        if (arg == "--bench") {
+            options.bench = true;
+            continue;
+        }
+        if (arg == "--unicode") {
+            options.unicode = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return std::nullopt;
+        }
+        if (arg == "--record") {
+            options.record_path = argv[++i];
+            continue;
+        }
+        if (arg == "--replay") {
+            options.replay_path = argv[++i];
+            continue;
+        }
+        if (arg == "--dump-output") {
+            options.dump_path = argv[++i];
+            continue;
+        }
+        if (arg == "--save") {
+            options.save_path = argv[++i];
+            continue;
+        }
+        if (arg == "--load") {
+            options.load_path = argv[++i];
+            continue;
+        }
+        if (arg == "--save-chunked") {
+            options.save_chunked_path = argv[++i];
+            continue;
+        }
+        if (arg == "--load-chunked") {
+            options.load_chunked_path = argv[++i];
+            continue;
+        }
+        if (arg == "--export-text") {
+            options.text_path = argv[++i];
+            continue;
+        }
+        if (arg == "--export-svg") {
+            options.svg_path = argv[++i];
+            continue;
+        }
+        if (arg == "--import-png") {
+            options.png_path = argv[++i];
+            continue;
+        }
+        if (arg == "--mask") {
+            options.mask_path = argv[++i];
+            continue;
+        }
+        if (arg == "--algorithm") {
+            auto* generator{generators::find(argv[++i])};
+            if (!generator) {
+                return std::nullopt;
+            }
+            options.algorithm = generator->algorithm;
+            continue;
+        }
+        if (arg == "--costs") {
+            options.costs_path = argv[++i];
+            continue;
+        }
+        if (arg == "--topology") {
+            options.topology = argv[++i];
+            if (options.topology != "square" && options.topology != "hex" && options.topology != "triangle") {
+                return std::nullopt;
+            }
+            continue;
+        }
+        if (arg == "--save-layers") {
+            options.layers_path = argv[++i];
+            continue;
+        }
+        if (arg == "--braid") {
+            std::string_view text{argv[++i]};
+            auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), options.braid);
+            if (error != std::errc{} || end != text.data() + text.size() || options.braid < 0.0 ||
+                options.braid > 1.0) {
+                return std::nullopt;
+            }
+            continue;
+        }
+        if (arg == "--wrap") {
+            std::string_view wrap{argv[++i]};
+            if (wrap == "none") {
+                options.wrap = Wrap::None;
+            } else if (wrap == "cylinder") {
+                options.wrap = Wrap::Cylinder;
+            } else if (wrap == "torus") {
+                options.wrap = Wrap::Torus;
+            } else {
+                return std::nullopt;
+            }
+            continue;
+        }
+        if (arg == "--seed") {
+            std::string_view text{argv[++i]};
+            auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), options.seed);
+            if (error != std::errc{} || end != text.data() + text.size()) {
+                return std::nullopt;
+            }
+            options.has_seed = true;
+            continue;
+        }
+        std::optional<int32_t> value{parse_number(argv[++i])};
+        if (!value) {
+            return std::nullopt;
+        }
+        if (arg == "--cols") {
+            options.cols = *value;
+        } else if (arg == "--rows") {
+            options.rows = *value;
+        } else if (arg == "--steps") {
+            options.steps_per_frame = *value;
+        } else if (arg == "--threads") {
+            options.threads = *value;
+        } else if (arg == "--layers") {
+            options.layers = *value;
+        } else if (arg == "--png-pitch") {
+            options.png_pitch = *value;
+        } else if (arg == "--dump-frames") {
+            options.dump_every = *value;
+            options.headless = true;
+        } else {
+            return std::nullopt;
+        }
+    }
+    return options;
+}
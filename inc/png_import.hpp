@@ -0,0 +1,181 @@
+#pragma once
+
+#include "bit_plane.hpp"
+#include "wall_grid.hpp"
+#include <algorithm>
+#include <csetjmp>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <png.h>
+#include <string>
+#include <vector>
+
+// Reads mazes drawn as images, or masks of the cells a maze may use. A maze image has square cells of `pitch` pixels
+// with the walls on the grid lines between them, so it is `cols * pitch + 1` pixels wide including the border. A wall
+// is sampled in the middle of its grid line segment and counts when the pixel is dark.
+//
+// The image is decoded one row at a time into a single gray row buffer, never as a full frame. Interlaced images would
+// need all passes in memory and are rejected.
+class PngImporter {
+  public:
+    // Wall pixels are darker than this gray value.
+    constexpr static uint8_t THRESHOLD{128};
+
+    PngImporter() = default;
+    PngImporter(const PngImporter&) = delete;
+    PngImporter& operator=(const PngImporter&) = delete;
+
+    ~PngImporter() {
+        close();
+    }
+
+    bool open(const std::string& path) {
+        close();
+        m_file = std::fopen(path.c_str(), "rb");
+        if (!m_file) {
+            return false;
+        }
+        png_byte signature[8];
+        if (std::fread(signature, 1, sizeof(signature), m_file) != sizeof(signature) ||
+            png_sig_cmp(signature, 0, sizeof(signature)) != 0) {
+            return false;
+        }
+        m_png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+        m_info = (m_png) ? png_create_info_struct(m_png) : nullptr;
+        if (!m_info) {
+            return false;
+        }
+        // libpng reports errors by jumping back here
+        if (setjmp(png_jmpbuf(m_png))) {
+            return false;
+        }
+        png_init_io(m_png, m_file);
+        png_set_sig_bytes(m_png, sizeof(signature));
+        png_read_info(m_png, m_info);
+        if (png_get_interlace_type(m_png, m_info) != PNG_INTERLACE_NONE) {
+            return false;
+        }
+        // whatever the format, the rows arrive as 8 bit gray
+        png_set_expand(m_png);
+        png_set_strip_16(m_png);
+        png_set_strip_alpha(m_png);
+        if (png_get_color_type(m_png, m_info) & PNG_COLOR_MASK_COLOR) {
+            png_set_rgb_to_gray_fixed(m_png, 1, -1, -1);
+        }
+        png_read_update_info(m_png, m_info);
+        m_width = png_get_image_width(m_png, m_info);
+        m_height = png_get_image_height(m_png, m_info);
+        return png_get_rowbytes(m_png, m_info) == m_width;
+    }
+
+    uint32_t width() const {
+        return m_width;
+    }
+
+    uint32_t height() const {
+        return m_height;
+    }
+
+    // Converts the image into walls, nothing if its size does not fit the pitch or the border is not closed.
+    std::optional<WallGrid> walls(uint32_t pitch) {
+        if (pitch < 2 || m_width <= pitch || m_height <= pitch || (m_width - 1) % pitch != 0 ||
+            (m_height - 1) % pitch != 0) {
+            return std::nullopt;
+        }
+        std::size_t cols{(m_width - 1) / pitch};
+        std::size_t rows{(m_height - 1) / pitch};
+        WallGrid walls(cols, rows);
+        std::vector<png_byte> row(m_width);
+        auto dark = [&](std::size_t x) { return row[x] < THRESHOLD; };
+        for (uint32_t y = 0; y < m_height; ++y) {
+            if (!read_row(row.data()) || !dark(0) || !dark(m_width - 1)) {
+                return std::nullopt;
+            }
+            if (y == 0 || y == m_height - 1) {
+                if (!std::ranges::all_of(row, [](png_byte gray) { return gray < THRESHOLD; })) {
+                    return std::nullopt;
+                }
+            } else if (y % pitch == 0) {
+                for (std::size_t col = 0; col < cols; ++col) {
+                    if (!dark(col * pitch + pitch / 2)) {
+                        walls.south().reset(col, y / pitch - 1);
+                    }
+                }
+            } else if (y % pitch == pitch / 2) {
+                for (std::size_t col = 0; col + 1 < cols; ++col) {
+                    if (!dark((col + 1) * pitch)) {
+                        walls.east().reset(col, y / pitch);
+                    }
+                }
+            }
+        }
+        return walls;
+    }
+
+    // One cell per pixel, dark pixels are the cells taking part in a masked maze. Nothing if no pixel is dark.
+    std::optional<BitPlane> mask() {
+        BitPlane mask(m_width, m_height, false);
+        std::vector<png_byte> row(m_width);
+        for (uint32_t y = 0; y < m_height; ++y) {
+            if (!read_row(row.data())) {
+                return std::nullopt;
+            }
+            for (uint32_t x = 0; x < m_width; ++x) {
+                if (row[x] < THRESHOLD) {
+                    mask.set(x, y);
+                }
+            }
+        }
+        if (mask.count() == 0) {
+            return std::nullopt;
+        }
+        return mask;
+    }
+
+    // One cost per pixel for a maze of `cols` by `rows` cells, from 1 for black to 16 for white. Nothing if the size of
+    // the image doesn't match.
+    std::optional<std::vector<uint8_t>> costs(std::size_t cols, std::size_t rows) {
+        if (m_width != cols || m_height != rows) {
+            return std::nullopt;
+        }
+        std::vector<uint8_t> costs(cols * rows);
+        for (uint32_t y = 0; y < m_height; ++y) {
+            auto* row{costs.data() + y * cols};
+            if (!read_row(row)) {
+                return std::nullopt;
+            }
+            std::ranges::transform(
+                row, row + cols, row, [](png_byte gray) { return static_cast<uint8_t>(1 + gray / 16); });
+        }
+        return costs;
+    }
+
+    void close() {
+        if (m_png) {
+            png_destroy_read_struct(&m_png, (m_info) ? &m_info : nullptr, nullptr);
+            m_png = nullptr;
+            m_info = nullptr;
+        }
+        if (m_file) {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+  private:
+    // Kept apart so the jump on a decoding error skips no destructors.
+    bool read_row(png_bytep row) {
+        if (setjmp(png_jmpbuf(m_png))) {
+            return false;
+        }
+        png_read_row(m_png, row, nullptr);
+        return true;
+    }
+
+    std::FILE* m_file{nullptr};
+    png_structp m_png{nullptr};
+    png_infop m_info{nullptr};
+    uint32_t m_width{0};
+    uint32_t m_height{0};
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// xoshiro256** seeded through splitmix64, the same seed always produces the same maze.
+class Random {
+  public:
+    explicit Random(uint64_t seed = 0) {
+        reseed(seed);
+    }
+
+    void reseed(uint64_t seed) {
+        for (auto& word : m_state) {
+            seed += 0x9E3779B97F4A7C15;
+            auto z{seed};
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        auto result{rotl(m_state[1] * 5, 7) * 9};
+        auto t{m_state[1] << 17};
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, bound) using the multiply-shift reduction, bound has to be > 0.
+    uint64_t below(uint64_t bound) {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * bound) >> 64);
+    }
+
+  private:
+    static uint64_t rotl(uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    std::array<uint64_t, 4> m_state{};
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Adaptive binary range coder (the LZMA flavour). Each bit is coded with a probability that adapts to the bits seen in
+// the same context, so well predicted bits cost a small fraction of a bit.
+namespace range_coder {
+constexpr static uint32_t PROBABILITY_BITS{11};
+constexpr static uint16_t PROBABILITY_INIT{1 << (PROBABILITY_BITS - 1)};
+constexpr static uint32_t ADAPT_SHIFT{5};
+constexpr static uint32_t TOP{1 << 24};
+
+using Probability = uint16_t;
+
+// Moves `probability`, the chance of a 0, a step towards the bit just coded.
+inline void adapt(Probability& probability, bool bit) {
+    if (!bit) {
+        probability = static_cast<Probability>(probability + (((1U << PROBABILITY_BITS) - probability) >> ADAPT_SHIFT));
+    } else {
+        probability = static_cast<Probability>(probability - (probability >> ADAPT_SHIFT));
+    }
+}
+} // namespace range_coder
+
+class RangeEncoder {
+  public:
+    explicit RangeEncoder(std::vector<uint8_t>& output) : m_output(output) {};
+
+    void encode(range_coder::Probability& probability, bool bit) {
+        auto bound{(m_range >> range_coder::PROBABILITY_BITS) * probability};
+        if (!bit) {
+            m_range = bound;
+        } else {
+            m_low += bound;
+            m_range -= bound;
+        }
+        range_coder::adapt(probability, bit);
+        while (m_range < range_coder::TOP) {
+            m_range <<= 8;
+            shift_low();
+        }
+    }
+
+    void flush() {
+        for (int i = 0; i < 5; ++i) {
+            shift_low();
+        }
+    }
+
+  private:
+    void shift_low() {
+        if (static_cast<uint32_t>(m_low) < 0xFF000000 || (m_low >> 32) != 0) {
+            auto carry{static_cast<uint8_t>(m_low >> 32)};
+            auto byte{m_cache};
+            do {
+                m_output.push_back(static_cast<uint8_t>(byte + carry));
+                byte = 0xFF;
+            } while (--m_cache_size != 0);
+            m_cache = static_cast<uint8_t>(m_low >> 24);
+        }
+        ++m_cache_size;
+        m_low = (m_low & 0x00FFFFFF) << 8;
+    }
+
+    std::vector<uint8_t>& m_output;
+    uint64_t m_low{0};
+    uint32_t m_range{0xFFFFFFFF};
+    uint8_t m_cache{0};
+    uint64_t m_cache_size{1};
+};
+
+class RangeDecoder {
+  public:
+    RangeDecoder(const uint8_t* input, std::size_t size) : m_input(input), m_end(input + size) {
+        for (int i = 0; i < 5; ++i) {
+            m_code = (m_code << 8) | next_byte();
+        }
+    }
+
+    bool decode(range_coder::Probability& probability) {
+        auto bound{(m_range >> range_coder::PROBABILITY_BITS) * probability};
+        bool bit{m_code >= bound};
+        if (!bit) {
+            m_range = bound;
+        } else {
+            m_code -= bound;
+            m_range -= bound;
+        }
+        range_coder::adapt(probability, bit);
+        if (m_range < range_coder::TOP) {
+            m_range <<= 8;
+            m_code = (m_code << 8) | next_byte();
+        }
+        return bit;
+    }
+
+  private:
+    // Reading past the end yields zeros, a truncated chunk decodes to garbage but never reads out of bounds.
+    uint32_t next_byte() {
+        return (m_input < m_end) ? *m_input++ : 0;
+    }
+
+    const uint8_t* m_input;
+    const uint8_t* m_end;
+    uint32_t m_code{0};
+    uint32_t m_range{0xFFFFFFFF};
+};
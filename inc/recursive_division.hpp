@@ -0,0 +1,122 @@
+#pragma once
+
+#include "random.hpp"
+#include "task_pool.hpp"
+#include "wall_grid.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+// Recursive division, the wall adding generator. It starts from a grid without inner walls and splits every chamber in
+// two with a wall that has a single passage, until the chambers are one cell wide or high. Each chamber draws from a
+// generator seeded by its parent, so the walls don't depend on which thread divided which chamber.
+//
+// Sibling chambers are divided in parallel as tasks of a `TaskPool`. Walls are written straight into the wall planes,
+// horizontal walls a row span at a time. Chambers side by side share the words at their edges, so words which are not
+// entirely inside the chamber are only updated atomically.
+namespace recursive_division {
+// chambers of fewer cells are divided by the thread that made them
+constexpr static std::size_t TASK_CELLS{128 * 128};
+
+struct Chamber {
+    std::size_t col;
+    std::size_t row;
+    std::size_t cols;
+    std::size_t rows;
+    uint64_t seed;
+};
+
+inline void set_bits(uint64_t& word, uint64_t bits) {
+    std::atomic_ref(word).fetch_or(bits, std::memory_order_relaxed);
+}
+
+inline void reset_bits(uint64_t& word, uint64_t bits) {
+    std::atomic_ref(word).fetch_and(~bits, std::memory_order_relaxed);
+}
+
+inline uint64_t bit(std::size_t col) {
+    return uint64_t(1) << (col % BitPlane::WORD_BITS);
+}
+
+// Sets the bits of `count` cells from `col` on in a row of `plane`.
+inline void set_span(BitPlane& plane, std::size_t col, std::size_t row, std::size_t count) {
+    auto* words{plane.row_words(row)};
+    auto first_word{col / BitPlane::WORD_BITS};
+    auto last_word{(col + count - 1) / BitPlane::WORD_BITS};
+    auto head{~uint64_t(0) << (col % BitPlane::WORD_BITS)};
+    auto tail{~uint64_t(0) >> (BitPlane::WORD_BITS - 1 - (col + count - 1) % BitPlane::WORD_BITS)};
+    if (first_word == last_word) {
+        set_bits(words[first_word], head & tail);
+        return;
+    }
+    set_bits(words[first_word], head);
+    std::fill(words + first_word + 1, words + last_word, ~uint64_t(0));
+    set_bits(words[last_word], tail);
+}
+
+// Opens all walls between the cells, the walls of the last column and row stay.
+inline void clear(WallGrid& walls) {
+    auto& east{walls.east()};
+    auto& south{walls.south()};
+    std::fill_n(east.data(), east.word_count(), 0);
+    std::fill_n(south.data(), south.word_count(), 0);
+    for (std::size_t row = 0; row < walls.rows(); ++row) {
+        east.set(walls.cols() - 1, row);
+    }
+    set_span(south, 0, walls.rows() - 1, walls.cols());
+}
+
+inline void divide(WallGrid& walls, Chamber chamber, TaskPool* pool) {
+    while (chamber.cols > 1 && chamber.rows > 1) {
+        Random random(chamber.seed);
+        auto horizontal{(chamber.cols == chamber.rows) ? (random.next() & 1) != 0 : chamber.rows > chamber.cols};
+        Chamber first{chamber};
+        Chamber second{chamber};
+        if (horizontal) {
+            // south walls of the last row of the first chamber
+            auto split{1 + random.below(chamber.rows - 1)};
+            auto wall_row{chamber.row + split - 1};
+            auto passage{chamber.col + random.below(chamber.cols)};
+            set_span(walls.south(), chamber.col, wall_row, chamber.cols);
+            reset_bits(walls.south().row_words(wall_row)[passage / BitPlane::WORD_BITS], bit(passage));
+            first.rows = split;
+            second.row += split;
+            second.rows -= split;
+        } else {
+            // east walls of the last column of the first chamber
+            auto split{1 + random.below(chamber.cols - 1)};
+            auto wall_col{chamber.col + split - 1};
+            auto passage{chamber.row + random.below(chamber.rows)};
+            for (auto row{chamber.row}; row < chamber.row + chamber.rows; ++row) {
+                if (row != passage) {
+                    set_bits(walls.east().row_words(row)[wall_col / BitPlane::WORD_BITS], bit(wall_col));
+                }
+            }
+            first.cols = split;
+            second.col += split;
+            second.cols -= split;
+        }
+        first.seed = random.next();
+        second.seed = random.next();
+        if (pool && second.cols * second.rows >= TASK_CELLS) {
+            pool->submit([&walls, second, pool] { divide(walls, second, pool); });
+        } else {
+            divide(walls, second, pool);
+        }
+        chamber = first;
+    }
+}
+
+// Generates the whole maze on `threads` threads.
+inline void carve(WallGrid& walls, uint64_t seed, std::size_t threads) {
+    clear(walls);
+    Chamber whole{0, 0, walls.cols(), walls.rows(), seed};
+    if (threads <= 1) {
+        divide(walls, whole, nullptr);
+        return;
+    }
+    TaskPool pool(threads);
+    pool.submit([&walls, whole, &pool] { divide(walls, whole, &pool); });
+    pool.wait();
+}
+} // namespace recursive_division
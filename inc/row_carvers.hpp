@@ -0,0 +1,89 @@
+#pragma once
+
+#include "random.hpp"
+#include "wall_grid.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Generators that carve every row on its own, binary tree and sidewinder. A row only writes its own east walls and the
+// south walls of the row above, and draws its coin flips from a generator seeded with the row, so the rows can be
+// carved in any order and on any number of threads with the same walls. Coin flips come 64 at a time and are applied
+// to a whole word of walls with a few bit operations. Neither carves across the edges of a wrapped maze.
+namespace row_carver {
+using CarveRow = void (*)(WallGrid& walls, std::size_t row, uint64_t seed);
+
+inline Random row_random(uint64_t seed, std::size_t row) {
+    return Random(seed ^ (row * 0xD1B54A32D192ED03));
+}
+
+// Every cell carves north or east with equal chance, the first row only east and the last column only north.
+inline void binary_tree(WallGrid& walls, std::size_t row, uint64_t seed) {
+    auto random{row_random(seed, row)};
+    auto& east{walls.east()};
+    auto* east_words{east.row_words(row)};
+    auto* north_words{(row > 0) ? walls.south().row_words(row - 1) : nullptr};
+    auto last_col{walls.cols() - 1};
+    for (std::size_t word = 0; word < east.words_per_row(); ++word) {
+        auto valid{(word + 1 == east.words_per_row()) ? east.tail_mask() : ~uint64_t(0)};
+        // a set bit carves east, a clear one north
+        auto carve_east{(north_words) ? random.next() : ~uint64_t(0)};
+        if (word == last_col / BitPlane::WORD_BITS) {
+            carve_east &= ~(uint64_t(1) << (last_col % BitPlane::WORD_BITS));
+        }
+        east_words[word] = ~carve_east & valid;
+        if (north_words) {
+            north_words[word] = carve_east & valid;
+        }
+    }
+}
+
+// Cells carve east with equal chance, building runs. Where a run ends one of its cells, chosen at random, carves north.
+// The first row is a single run without any opening north.
+inline void sidewinder(WallGrid& walls, std::size_t row, uint64_t seed) {
+    auto random{row_random(seed, row)};
+    auto& east{walls.east()};
+    auto* east_words{east.row_words(row)};
+    auto* north_words{(row > 0) ? walls.south().row_words(row - 1) : nullptr};
+    auto last_col{walls.cols() - 1};
+    std::size_t run_start{0};
+    for (std::size_t word = 0; word < east.words_per_row(); ++word) {
+        auto valid{(word + 1 == east.words_per_row()) ? east.tail_mask() : ~uint64_t(0)};
+        auto carve_east{((north_words) ? random.next() : ~uint64_t(0)) & valid};
+        if (word == last_col / BitPlane::WORD_BITS) {
+            carve_east &= ~(uint64_t(1) << (last_col % BitPlane::WORD_BITS));
+        }
+        east_words[word] = ~carve_east & valid;
+        if (!north_words) {
+            continue;
+        }
+        north_words[word] = valid;
+        for (auto run_ends{~carve_east & valid}; run_ends != 0; run_ends &= run_ends - 1) {
+            auto run_end{word * BitPlane::WORD_BITS + static_cast<std::size_t>(std::countr_zero(run_ends))};
+            auto col{run_start + random.below(run_end - run_start + 1)};
+            north_words[col / BitPlane::WORD_BITS] &= ~(uint64_t(1) << (col % BitPlane::WORD_BITS));
+            run_start = run_end + 1;
+        }
+    }
+}
+
+// Carves all rows with `carve_row`, split into one band of rows per thread.
+inline void carve_rows(WallGrid& walls, uint64_t seed, std::size_t threads, CarveRow carve_row) {
+    auto rows{walls.rows()};
+    threads = std::clamp<std::size_t>(threads, 1, rows);
+    auto band{(rows + threads - 1) / threads};
+    std::vector<std::jthread> workers;
+    for (std::size_t first = band; first < rows; first += band) {
+        workers.emplace_back([&walls, seed, carve_row, first, last = std::min(first + band, rows)] {
+            for (auto row = first; row < last; ++row) {
+                carve_row(walls, row, seed);
+            }
+        });
+    }
+    for (std::size_t row = 0; row < std::min(band, rows); ++row) {
+        carve_row(walls, row, seed);
+    }
+}
+} // namespace row_carver
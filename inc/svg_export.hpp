@@ -0,0 +1,155 @@
+#pragma once
+
+#include "bit_plane.hpp"
+#include "text_export.hpp"
+#include "wall_grid.hpp"
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+struct SvgSummary {
+    std::size_t bytes;
+    std::size_t segments;
+    std::size_t walls;
+};
+
+// Writes the walls as a single SVG path. Collinear neighbouring walls are merged into one segment: the horizontal
+// lines are swept along the rows of the south plane, the vertical lines by following runs of the east plane down the
+// columns, both a word of cells at a time.
+class SvgExporter {
+  public:
+    SvgExporter(const WallGrid& walls, uint32_t cell_size) : m_walls(walls), m_cell_size(cell_size) {};
+
+    // Returns what was written, or nothing if writing failed.
+    std::optional<SvgSummary> write(std::FILE* file) const {
+        BufferedWriter writer(file);
+        auto cols{m_walls.cols()};
+        auto rows{m_walls.rows()};
+        writer.write(R"(<svg xmlns="http://www.w3.org/2000/svg" width=")");
+        write_number(writer, cols * m_cell_size + 2);
+        writer.write(R"(" height=")");
+        write_number(writer, rows * m_cell_size + 2);
+        writer.write(R"(" viewBox="-1 -1 )");
+        write_number(writer, cols * m_cell_size + 2);
+        writer.write(" ");
+        write_number(writer, rows * m_cell_size + 2);
+        writer.write(R"(">)"
+                     "\n"
+                     R"(<path fill="none" stroke="black" stroke-width="1" stroke-linecap="square" d=")");
+
+        SvgSummary summary{0, 0, 0};
+        auto horizontal = [&](std::size_t first_col, std::size_t last_col, std::size_t y) {
+            segment(writer, 'h', first_col, y, last_col - first_col);
+            ++summary.segments;
+        };
+        auto vertical = [&](std::size_t x, std::size_t first_row, std::size_t last_row) {
+            segment(writer, 'v', x, first_row, last_row - first_row);
+            ++summary.segments;
+        };
+
+        // the north and south border both show the south walls of the last row, the west and east border the east
+        // walls of the last column, which are only open where a wrapping maze joins its edges
+        for (std::size_t y = 0; y <= rows; ++y) {
+            auto row{((y == 0) ? rows : y) - 1};
+            summary.walls += count_runs(m_walls.south().row_words(row), cols, [&](std::size_t first, std::size_t last) {
+                horizontal(first, last, y);
+            });
+        }
+
+        // a vertical run starts where a wall appears compared to the row above and ends where it disappears
+        auto words_per_row{BitPlane::words_per_row(cols)};
+        auto inner_mask = [&](std::size_t word) {
+            return (word + 1 == words_per_row) ? (uint64_t(1) << ((cols - 1) % BitPlane::WORD_BITS)) - 1 : ~uint64_t(0);
+        };
+        std::vector<uint64_t> previous(words_per_row, 0);
+        std::vector<uint32_t> run_start(cols, 0);
+        bool previous_border{false};
+        std::size_t border_start{0};
+        for (std::size_t row = 0; row <= rows; ++row) {
+            for (std::size_t word = 0; word < words_per_row; ++word) {
+                auto current{(row < rows) ? m_walls.east().row_words(row)[word] & inner_mask(word) : 0};
+                summary.walls += static_cast<std::size_t>(std::popcount(current));
+                for (auto changed{current ^ previous[word]}; changed != 0; changed &= changed - 1) {
+                    auto col{word * BitPlane::WORD_BITS + static_cast<std::size_t>(std::countr_zero(changed))};
+                    if ((current >> (col % BitPlane::WORD_BITS)) & 1) {
+                        run_start[col] = static_cast<uint32_t>(row);
+                    } else {
+                        vertical(col + 1, run_start[col], row);
+                    }
+                }
+                previous[word] = current;
+            }
+            auto border{row < rows && m_walls.east().test(cols - 1, row)};
+            if (border && !previous_border) {
+                border_start = row;
+            } else if (!border && previous_border) {
+                vertical(0, border_start, row);
+                vertical(cols, border_start, row);
+            }
+            summary.walls += 2 * static_cast<std::size_t>(border);
+            previous_border = border;
+        }
+
+        writer.write("\"/>\n</svg>\n");
+        summary.bytes = writer.bytes_written();
+        if (!writer.flush()) {
+            return std::nullopt;
+        }
+        return summary;
+    }
+
+  private:
+    // Calls `run(first, last)` for every run of set bits in a padded row and returns the number of set bits.
+    template <typename Run>
+    static std::size_t count_runs(const uint64_t* words, std::size_t cols, Run&& run) {
+        std::size_t count{0};
+        std::size_t first{0};
+        bool in_run{false};
+        for (std::size_t word = 0; word < BitPlane::words_per_row(cols); ++word) {
+            auto bits{words[word]};
+            count += static_cast<std::size_t>(std::popcount(bits));
+            auto base{word * BitPlane::WORD_BITS};
+            std::size_t position{0};
+            while (position < BitPlane::WORD_BITS) {
+                auto rest{((in_run) ? ~bits : bits) >> position};
+                if (rest == 0) {
+                    break;
+                }
+                position += static_cast<std::size_t>(std::countr_zero(rest));
+                if (in_run) {
+                    run(first, base + position);
+                } else {
+                    first = base + position;
+                }
+                in_run = !in_run;
+            }
+        }
+        if (in_run) {
+            run(first, cols);
+        }
+        return count;
+    }
+
+    void segment(BufferedWriter& writer, char direction, std::size_t x, std::size_t y, std::size_t length) const {
+        writer.write("M");
+        write_number(writer, x * m_cell_size);
+        writer.write(" ");
+        write_number(writer, y * m_cell_size);
+        writer.write(std::string_view(&direction, 1));
+        write_number(writer, length * m_cell_size);
+    }
+
+    static void write_number(BufferedWriter& writer, std::size_t value) {
+        std::array<char, 24> digits{};
+        auto result{std::to_chars(digits.data(), digits.data() + digits.size(), value)};
+        writer.write(std::string_view(digits.data(), static_cast<std::size_t>(result.ptr - digits.data())));
+    }
+
+    const WallGrid& m_walls;
+    std::size_t m_cell_size;
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Work stealing pool for tasks that submit further tasks. Every thread has its own queue, pushes its new tasks to the
+// back and takes its next task from the back as well, so it keeps working on the smallest and most recent tasks while
+// idle threads steal the oldest and largest tasks from the front of the other queues.
+//
+// The thread calling `wait` joins the workers until all tasks are done, so a pool of `threads` runs `threads - 1`
+// workers of its own.
+class TaskPool {
+  public:
+    using Task = std::move_only_function<void()>;
+
+    explicit TaskPool(std::size_t threads) : m_queues(std::max<std::size_t>(threads, 1)) {
+        for (std::size_t i = 1; i < m_queues.size(); ++i) {
+            m_workers.emplace_back([this, i](std::stop_token stop) { work(i, stop); });
+        }
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    ~TaskPool() {
+        for (auto& worker : m_workers) {
+            worker.request_stop();
+        }
+        m_wake.notify_all();
+    }
+
+    std::size_t threads() const {
+        return m_queues.size();
+    }
+
+    // Queues `task` on the calling thread's queue, threads outside the pool use the queue of the waiting thread.
+    void submit(Task task) {
+        auto index{(t_pool == this) ? t_index : 0};
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::scoped_lock lock(m_queues[index].mutex);
+            m_queues[index].tasks.push_back(std::move(task));
+        }
+        m_queued.fetch_add(1, std::memory_order_release);
+        m_wake.notify_one();
+    }
+
+    // Runs tasks until every submitted task, including the ones submitted meanwhile, has finished.
+    void wait() {
+        t_pool = this;
+        t_index = 0;
+        while (m_pending.load(std::memory_order_acquire) > 0) {
+            if (!run_one(0)) {
+                std::this_thread::yield();
+            }
+        }
+        t_pool = nullptr;
+    }
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void work(std::size_t index, std::stop_token stop) {
+        t_pool = this;
+        t_index = index;
+        while (!stop.stop_requested()) {
+            if (run_one(index)) {
+                continue;
+            }
+            std::unique_lock lock(m_sleep);
+            m_wake.wait_for(lock, std::chrono::milliseconds(1), [&] {
+                return stop.stop_requested() || m_queued.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+
+    // Runs the newest task of the own queue or else the oldest one of another queue, false if there was none.
+    bool run_one(std::size_t index) {
+        auto task{take(index, true)};
+        for (std::size_t i = 1; !task && i < m_queues.size(); ++i) {
+            task = take((index + i) % m_queues.size(), false);
+        }
+        if (!task) {
+            return false;
+        }
+        (*task)();
+        task.reset();
+        m_pending.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    std::optional<Task> take(std::size_t index, bool newest) {
+        auto& queue{m_queues[index]};
+        std::scoped_lock lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return std::nullopt;
+        }
+        std::optional<Task> task;
+        if (newest) {
+            task.emplace(std::move(queue.tasks.back()));
+            queue.tasks.pop_back();
+        } else {
+            task.emplace(std::move(queue.tasks.front()));
+            queue.tasks.pop_front();
+        }
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    inline static thread_local TaskPool* t_pool{nullptr};
+    inline static thread_local std::size_t t_index{0};
+
+    std::vector<Queue> m_queues;
+    // submitted tasks not finished yet and tasks still waiting in a queue
+    std::atomic<std::size_t> m_pending{0};
+    std::atomic<std::size_t> m_queued{0};
+    std::mutex m_sleep;
+    std::condition_variable m_wake;
+    // declared last so the workers stop before anything they use is destroyed
+    std::vector<std::jthread> m_workers;
+};
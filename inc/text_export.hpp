@@ -0,0 +1,122 @@
+#pragma once
+
+#include "wall_grid.hpp"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum class TextStyle : uint8_t { Ascii, Unicode };
+
+// Collects output in a large buffer and hands it to the file in few big writes.
+class BufferedWriter {
+  public:
+    constexpr static std::size_t CAPACITY{std::size_t(1) << 20};
+
+    explicit BufferedWriter(std::FILE* file) : m_file(file), m_buffer(CAPACITY) {};
+
+    void write(std::string_view text) {
+        if (m_size + text.size() > CAPACITY) {
+            flush();
+        }
+        std::memcpy(m_buffer.data() + m_size, text.data(), text.size());
+        m_size += text.size();
+    }
+
+    bool flush() {
+        m_written += m_size;
+        m_ok = m_ok && std::fwrite(m_buffer.data(), 1, m_size, m_file) == m_size;
+        m_size = 0;
+        return m_ok;
+    }
+
+    std::size_t bytes_written() const {
+        return m_written + m_size;
+    }
+
+  private:
+    std::FILE* m_file;
+    std::vector<char> m_buffer;
+    std::size_t m_size{0};
+    std::size_t m_written{0};
+    bool m_ok{true};
+};
+
+// Renders the walls as text, two lines per row: the walls above the row with their corners and the row itself. The
+// output is produced row by row from the wall bits, so memory stays bounded whatever the size of the maze.
+class TextExporter {
+  public:
+    TextExporter(const WallGrid& walls, TextStyle style) : m_walls(walls), m_style(style) {};
+
+    // Returns the number of bytes written, or nothing if writing failed.
+    std::optional<std::size_t> write(std::FILE* file) const {
+        BufferedWriter writer(file);
+        for (std::size_t y = 0; y <= m_walls.rows(); ++y) {
+            write_corner_line(writer, y);
+            if (y < m_walls.rows()) {
+                write_cell_line(writer, y);
+            }
+        }
+        auto bytes{writer.bytes_written()};
+        if (!writer.flush()) {
+            return std::nullopt;
+        }
+        return bytes;
+    }
+
+  private:
+    // Wall on the vertical grid line `x` in `row`. The west border shows the east walls of the last column, which are
+    // only open where a wrapping maze joins its edges.
+    bool vertical(std::size_t x, std::size_t row) const {
+        return m_walls.east().test(((x == 0) ? m_walls.cols() : x) - 1, row);
+    }
+
+    // Wall on the horizontal grid line `y` in `col`.
+    bool horizontal(std::size_t y, std::size_t col) const {
+        return m_walls.south().test(col, ((y == 0) ? m_walls.rows() : y) - 1);
+    }
+
+    void write_corner_line(BufferedWriter& writer, std::size_t y) const {
+        auto cols{m_walls.cols()};
+        for (std::size_t x = 0; x <= cols; ++x) {
+            if (m_style == TextStyle::Ascii) {
+                writer.write("+");
+            } else {
+                // the lines meeting at the corner, bit 0 up, bit 1 right, bit 2 down and bit 3 left
+                auto up{y > 0 && vertical(x, y - 1)};
+                auto right{x < cols && horizontal(y, x)};
+                auto down{y < m_walls.rows() && vertical(x, y)};
+                auto left{x > 0 && horizontal(y, x - 1)};
+                auto lines{static_cast<std::size_t>(up) | (static_cast<std::size_t>(right) << 1) |
+                           (static_cast<std::size_t>(down) << 2) | (static_cast<std::size_t>(left) << 3)};
+                writer.write(BOX_CORNERS[lines]);
+            }
+            if (x < cols) {
+                writer.write((horizontal(y, x)) ? HORIZONTAL[std::to_underlying(m_style)] : "  ");
+            }
+        }
+        writer.write("\n");
+    }
+
+    void write_cell_line(BufferedWriter& writer, std::size_t row) const {
+        for (std::size_t x = 0; x <= m_walls.cols(); ++x) {
+            writer.write((vertical(x, row)) ? VERTICAL[std::to_underlying(m_style)] : " ");
+            if (x < m_walls.cols()) {
+                writer.write("  ");
+            }
+        }
+        writer.write("\n");
+    }
+
+    constexpr static std::array<std::string_view, 2> HORIZONTAL{"--", "──"};
+    constexpr static std::array<std::string_view, 2> VERTICAL{"|", "│"};
+    constexpr static std::array<std::string_view, 16> BOX_CORNERS{
+        " ", "╵", "╶", "└", "╷", "│", "┌", "├", "╴", "┘", "─", "┴", "┐", "┤", "┬", "┼"};
+
+    const WallGrid& m_walls;
+    TextStyle m_style;
+};
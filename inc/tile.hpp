@@ -0,0 +1,91 @@
+#pragma once
+
+#include "olcPixelGameEngine.h"
+
+#include "cell.hpp"
+#include "maze.hpp"
+#include "maze_event.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Colors of the pixels making up a cell tile: the inside, the east wall column, the south wall row and the corner.
+struct TileColors {
+    olc::Pixel inside;
+    olc::Pixel east;
+    olc::Pixel south;
+    olc::Pixel corner;
+};
+
+inline TileColors tile_colors(const Cell& cell, olc::Pixel color) {
+    return {(cell.is_visited()) ? color : olc::BLUE,
+            (cell.has_wall(Direction::East)) ? olc::BLACK : color,
+            (cell.has_wall(Direction::South)) ? olc::BLACK : color,
+            olc::BLACK};
+}
+
+// Writes a tile into a row major pixel buffer, the same layout as `Cell::draw`: `w` x `h` inside pixels followed by a
+// one pixel wide east wall column and a one pixel high south wall row.
+template <typename T>
+void paint_tile(T* origin, std::size_t stride, std::size_t w, std::size_t h, T inside, T east, T south, T corner) {
+    for (std::size_t y = 0; y < h; ++y) {
+        auto* row{origin + y * stride};
+        std::fill_n(row, w, inside);
+        row[w] = east;
+    }
+    auto* row{origin + h * stride};
+    std::fill_n(row, w, south);
+    row[w] = corner;
+}
+
+// Cells whose tile has to be repainted, each cell is queued at most once.
+class DirtyCells {
+  public:
+    explicit DirtyCells(std::size_t size) : m_flags(size, false) {};
+
+    void mark(std::size_t index) {
+        if (!m_flags[index]) {
+            m_flags[index] = true;
+            m_cells.push_back(index);
+        }
+    }
+
+    // Marks every cell whose appearance the event changes.
+    void mark(const Maze& maze, const MazeEvent& event) {
+        mark(event.index);
+        auto mark_neighbour = [&](Direction direction) {
+            if (auto neighbour{maze.neighbour_index(event.index, direction)}; neighbour != Maze::NO_NEIGHBOUR) {
+                mark(neighbour);
+            }
+        };
+        switch (event.kind) {
+            case MazeEvent::Kind::Carve:
+            case MazeEvent::Kind::Path: {
+                mark_neighbour(event.direction);
+            } break;
+            case MazeEvent::Kind::Expand: {
+                // the solver scores the open neighbours, which changes their color
+                for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+                    if (!maze.has_wall(event.index, direction)) {
+                        mark_neighbour(direction);
+                    }
+                }
+            } break;
+            default:
+                break;
+        }
+    }
+
+    template <typename Paint>
+    void drain(Paint&& paint) {
+        for (auto index : m_cells) {
+            m_flags[index] = false;
+            paint(index);
+        }
+        m_cells.clear();
+    }
+
+  private:
+    std::vector<std::size_t> m_cells;
+    std::vector<bool> m_flags;
+};
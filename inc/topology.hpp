@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+// Shapes of the cells of a grid. Every topology numbers the sides of a cell from 0 and gives, for each kind of cell,
+// the offset to the neighbour behind every side. Cells of hex and triangle grids come in two kinds depending on their
+// position, the kind only selects a row of the offset table so looking up a neighbour never branches on the shape.
+struct Offset {
+    int32_t col;
+    int32_t row;
+};
+
+// Four sides: north, east, south and west.
+struct SquareTopology {
+    constexpr static std::size_t SIDES{4};
+    constexpr static std::array<std::array<Offset, SIDES>, 2> OFFSETS{{
+        {{{0, -1}, {1, 0}, {0, 1}, {-1, 0}}},
+        {{{0, -1}, {1, 0}, {0, 1}, {-1, 0}}},
+    }};
+
+    constexpr static std::size_t kind(std::size_t, std::size_t) {
+        return 0;
+    }
+
+    constexpr static std::size_t opposite(std::size_t side) {
+        return (side + 2) % SIDES;
+    }
+
+    // Lower bound of the number of steps between two cells.
+    static int32_t distance(int32_t col_a, int32_t row_a, int32_t col_b, int32_t row_b) {
+        return std::abs(col_a - col_b) + std::abs(row_a - row_b);
+    }
+};
+
+// Pointy topped hexagons with the odd rows shifted half a cell to the right. Six sides: east, south east, south west,
+// west, north west and north east.
+struct HexTopology {
+    constexpr static std::size_t SIDES{6};
+    constexpr static std::array<std::array<Offset, SIDES>, 2> OFFSETS{{
+        {{{1, 0}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}}},
+        {{{1, 0}, {1, 1}, {0, 1}, {-1, 0}, {0, -1}, {1, -1}}},
+    }};
+
+    constexpr static std::size_t kind(std::size_t, std::size_t row) {
+        return row & 1;
+    }
+
+    constexpr static std::size_t opposite(std::size_t side) {
+        return (side + 3) % SIDES;
+    }
+
+    // Exact distance, measured in cube coordinates.
+    static int32_t distance(int32_t col_a, int32_t row_a, int32_t col_b, int32_t row_b) {
+        auto x_a{col_a - (row_a - (row_a & 1)) / 2};
+        auto x_b{col_b - (row_b - (row_b & 1)) / 2};
+        auto dx{x_a - x_b};
+        auto dz{row_a - row_b};
+        return std::max({std::abs(dx), std::abs(dz), std::abs(dx + dz)});
+    }
+};
+
+// Triangles pointing up where `col + row` is even and down otherwise. Three sides: west, east and the base, which is
+// south for triangles pointing up and north for those pointing down.
+struct TriangleTopology {
+    constexpr static std::size_t SIDES{3};
+    constexpr static std::array<std::array<Offset, SIDES>, 2> OFFSETS{{
+        {{{-1, 0}, {1, 0}, {0, 1}}},
+        {{{-1, 0}, {1, 0}, {0, -1}}},
+    }};
+
+    constexpr static std::size_t kind(std::size_t col, std::size_t row) {
+        return (col + row) & 1;
+    }
+
+    constexpr static std::size_t opposite(std::size_t side) {
+        return std::array<std::size_t, SIDES>{1, 0, 2}[side];
+    }
+
+    // Every step changes either the column or the row by one.
+    static int32_t distance(int32_t col_a, int32_t row_a, int32_t col_b, int32_t row_b) {
+        return std::abs(col_a - col_b) + std::abs(row_a - row_b);
+    }
+};
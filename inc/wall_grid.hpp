@@ -0,0 +1,91 @@
+#pragma once
+
+#include "bit_plane.hpp"
+#include "direction.hpp"
+#include <cstdint>
+#include <utility>
+
+// Walls of a maze as two bitplanes, a set bit is a wall. Every cell owns its east and south wall, the north and west
+// walls are the south and east walls of the neighbours. The outer border always counts as a wall.
+class WallGrid {
+  public:
+    WallGrid() = default;
+
+    // All walls standing.
+    WallGrid(std::size_t cols, std::size_t rows) : m_east(cols, rows, true), m_south(cols, rows, true) {};
+
+    WallGrid(BitPlane east, BitPlane south) : m_east(std::move(east)), m_south(std::move(south)) {};
+
+    // All walls standing again on a grid of `cols` x `rows`, reusing the words of the planes.
+    void reshape(std::size_t cols, std::size_t rows) {
+        m_east.reshape(cols, rows, true);
+        m_south.reshape(cols, rows, true);
+    }
+
+    std::size_t cols() const {
+        return m_east.cols();
+    }
+
+    std::size_t rows() const {
+        return m_east.rows();
+    }
+
+    bool is_view() const {
+        return m_east.is_view();
+    }
+
+    bool has_wall(std::size_t col, std::size_t row, Direction direction) const {
+        switch (direction) {
+            case Direction::North:
+                return row == 0 || m_south.test(col, row - 1);
+            case Direction::East:
+                return m_east.test(col, row);
+            case Direction::South:
+                return m_south.test(col, row);
+            case Direction::West:
+                return col == 0 || m_east.test(col - 1, row);
+            default:
+                return true;
+        }
+    }
+
+    // Removes the wall shared with the neighbour in `direction`, which has to exist.
+    void remove_wall(std::size_t col, std::size_t row, Direction direction) {
+        switch (direction) {
+            case Direction::North:
+                m_south.reset(col, row - 1);
+                break;
+            case Direction::East:
+                m_east.reset(col, row);
+                break;
+            case Direction::South:
+                m_south.reset(col, row);
+                break;
+            case Direction::West:
+                m_east.reset(col - 1, row);
+                break;
+            default:
+                break;
+        }
+    }
+
+    const BitPlane& east() const {
+        return m_east;
+    }
+
+    BitPlane& east() {
+        return m_east;
+    }
+
+    const BitPlane& south() const {
+        return m_south;
+    }
+
+    BitPlane& south() {
+        return m_south;
+    }
+
+  private:
+    BitPlane m_east;
+    BitPlane m_south;
+};
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "direction.hpp"
+#include "wall_grid.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Uniform spanning trees with Wilson's algorithm, run by several walkers at once without changing the distribution.
+//
+// Wilson's algorithm is cycle popping: every cell has a stack of random arrows to its neighbours, the top arrows form a
+// graph and whenever they close a cycle the arrows of that cycle are popped. Whatever the order the cycles are popped
+// in, the same cycles get popped and the same tree is left (Propp and Wilson), and that tree is uniform. Here the k-th
+// arrow of a cell is a hash of the seed, the cell and k, so the stacks are fixed by the seed and every order of popping
+// gives the same walls.
+//
+// Walkers start from every cell not yet in the tree and follow the top arrows. A walker claims the cells on its path,
+// pops a cycle once it runs into its own path and adds the path to the tree once it reaches the tree. Cycles are only
+// popped among cells of one walker, so they are cycles of the global arrows. When a walker runs into the path of
+// another one, the walker that started from the lower cell waits and the other one gives up its path and starts over,
+// so walkers never wait for each other in a circle.
+namespace wilson {
+struct Grid {
+    std::size_t cols;
+    std::size_t rows;
+    bool join_cols;
+    bool join_rows;
+
+    std::size_t size() const {
+        return cols * rows;
+    }
+
+    // Neighbour in `direction`, `size()` if there is none.
+    std::size_t neighbour(std::size_t index, Direction direction) const {
+        auto col{index % cols};
+        auto row{index / cols};
+        switch (direction) {
+            case Direction::North:
+                return (row > 0) ? index - cols : ((join_rows) ? index + (rows - 1) * cols : size());
+            case Direction::East:
+                return (col + 1 < cols) ? index + 1 : ((join_cols) ? index - col : size());
+            case Direction::South:
+                return (row + 1 < rows) ? index + cols : ((join_rows) ? col : size());
+            case Direction::West:
+                return (col > 0) ? index - 1 : ((join_cols) ? index + cols - 1 : size());
+            default:
+                return size();
+        }
+    }
+};
+
+// The `pop`-th arrow of a cell.
+inline Direction arrow(const Grid& grid, uint64_t seed, std::size_t index, uint32_t pop) {
+    auto hash{seed ^ (index * 0x9E3779B97F4A7C15) ^ (static_cast<uint64_t>(pop) * 0xD1B54A32D192ED03)};
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EB;
+    hash ^= hash >> 31;
+    std::array<Direction, 4> directions;
+    std::size_t count{0};
+    for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+        if (grid.neighbour(index, direction) != grid.size()) {
+            directions[count++] = direction;
+        }
+    }
+    return directions[static_cast<std::size_t>((static_cast<unsigned __int128>(hash) * count) >> 64)];
+}
+
+// Opens the wall between a cell and its neighbour in `direction`, other walkers write the same words.
+inline void open_wall(WallGrid& walls, const Grid& grid, std::size_t index, Direction direction) {
+    auto col{index % grid.cols};
+    auto row{index / grid.cols};
+    auto open = [](BitPlane& plane, std::size_t col, std::size_t row) {
+        auto& word{plane.row_words(row)[col / BitPlane::WORD_BITS]};
+        std::atomic_ref(word).fetch_and(~(uint64_t(1) << (col % BitPlane::WORD_BITS)), std::memory_order_relaxed);
+    };
+    switch (direction) {
+        case Direction::North:
+            open(walls.south(), col, (row > 0) ? row - 1 : grid.rows - 1);
+            break;
+        case Direction::East:
+            open(walls.east(), col, row);
+            break;
+        case Direction::South:
+            open(walls.south(), col, row);
+            break;
+        case Direction::West:
+            open(walls.east(), (col > 0) ? col - 1 : grid.cols - 1, row);
+            break;
+        default:
+            break;
+    }
+}
+
+// Most cells a grid may have, the state of a cell is 32 bits and walkers are numbered by their start cell plus one
+// below `IN_TREE`.
+constexpr static std::size_t MAX_CELLS{std::numeric_limits<uint32_t>::max() - 1};
+
+// Memory of the walkers, kept by the caller across grids so carving one grid after the other allocates nothing once it
+// has grown to the largest grid.
+struct State {
+    // per cell FREE, IN_TREE or the walker that claimed it, atomics can't be moved so this only grows by reallocating
+    std::unique_ptr<std::atomic<uint32_t>[]> cells;
+    std::size_t cell_capacity{0};
+    // both per cell and only touched by the walker holding the cell: the arrows popped so far and the cell after it on
+    // the walker's path, so the paths of all walkers together take a single link per cell
+    std::vector<uint32_t> pops;
+    std::vector<uint32_t> following;
+
+    void reserve(std::size_t cell_count) {
+        if (cell_capacity < cell_count) {
+            cells.reset(new std::atomic<uint32_t>[cell_count]);
+            cell_capacity = cell_count;
+        }
+        pops.assign(cell_count, 0);
+        following.resize(cell_count);
+    }
+
+    std::size_t memory_usage() const {
+        return cell_capacity * sizeof(std::atomic<uint32_t>) +
+               (pops.capacity() + following.capacity()) * sizeof(uint32_t);
+    }
+};
+
+// Carves a uniform spanning tree into `walls`, which have to be all closed, on `threads` threads with the walkers'
+// memory in `state`. Grids without cells or with more than `MAX_CELLS` are left as they are.
+inline void
+carve(WallGrid& walls, const Grid& grid, std::size_t root, uint64_t seed, std::size_t threads, State& state) {
+    constexpr static auto FREE{uint32_t(0)};
+    constexpr static auto IN_TREE{std::numeric_limits<uint32_t>::max()};
+    if (grid.size() == 0 || grid.size() > MAX_CELLS) {
+        return;
+    }
+    state.reserve(grid.size());
+    auto& cells{state.cells};
+    for (std::size_t i = 0; i < grid.size(); ++i) {
+        cells[i].store(FREE, std::memory_order_relaxed);
+    }
+    cells[root].store(IN_TREE, std::memory_order_relaxed);
+    auto& pops{state.pops};
+    auto& following{state.following};
+    std::atomic<std::size_t> next_start{0};
+
+    auto walk = [&] {
+        for (auto start{next_start.fetch_add(1)}; start < grid.size(); start = next_start.fetch_add(1)) {
+            auto walker{static_cast<uint32_t>(start + 1)};
+            // the path runs from `start` along `following` to `last`, empty while `last` is `grid.size()`
+            auto last{grid.size()};
+            auto claim = [&](std::size_t index) {
+                auto expected{FREE};
+                if (!cells[index].compare_exchange_strong(expected, walker, std::memory_order_acquire)) {
+                    return expected;
+                }
+                if (last != grid.size()) {
+                    following[last] = static_cast<uint32_t>(index);
+                }
+                last = index;
+                return walker;
+            };
+            // frees the cells after `from`, `from` itself if `inclusive`, a freed cell's link belongs to whoever
+            // claims it next so it is read before the cell is freed
+            auto release = [&](std::size_t from, bool inclusive) {
+                auto end{last};
+                last = (inclusive) ? grid.size() : from;
+                if (!inclusive && from == end) {
+                    return;
+                }
+                for (auto index{(inclusive) ? from : following[from]};;) {
+                    auto after{following[index]};
+                    cells[index].store(FREE, std::memory_order_release);
+                    if (index == end) {
+                        break;
+                    }
+                    index = after;
+                }
+            };
+
+            for (auto owner{claim(start)}; owner != IN_TREE;) {
+                if (owner != walker) {
+                    // the start is on another walker's path, wait until that walker is done with it
+                    std::this_thread::yield();
+                    owner = (cells[start].load(std::memory_order_acquire) == IN_TREE) ? IN_TREE : claim(start);
+                    continue;
+                }
+                auto current{last};
+                auto direction{arrow(grid, seed, current, pops[current])};
+                auto next{grid.neighbour(current, direction)};
+                auto next_owner{cells[next].load(std::memory_order_acquire)};
+                if (next_owner == IN_TREE) {
+                    for (auto index{start};; index = following[index]) {
+                        open_wall(walls, grid, index, arrow(grid, seed, index, pops[index]));
+                        cells[index].store(IN_TREE, std::memory_order_release);
+                        if (index == last) {
+                            break;
+                        }
+                    }
+                    owner = IN_TREE;
+                } else if (next_owner == walker) {
+                    // pop the cycle from `next` back to it, `next` stays on the path with its next arrow on top
+                    for (auto index{next};; index = following[index]) {
+                        ++pops[index];
+                        if (index == last) {
+                            break;
+                        }
+                    }
+                    release(next, false);
+                } else if (next_owner == FREE) {
+                    claim(next);
+                } else if (walker < next_owner) {
+                    std::this_thread::yield();
+                } else {
+                    release(start, true);
+                    std::this_thread::yield();
+                    owner = claim(start);
+                }
+            }
+        }
+    };
+
+    threads = std::clamp<std::size_t>(threads, 1, grid.size());
+    std::vector<std::jthread> walkers;
+    for (std::size_t i = 1; i < threads; ++i) {
+        walkers.emplace_back(walk);
+    }
+    walk();
+}
+} // namespace wilson
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// Edges joined to the opposite edge: a cylinder joins the west and east edge, a torus also the north and south edge.
+// The walls across a joined edge are the east walls of the last column and the south walls of the last row.
+enum class Wrap : uint8_t { None, Cylinder, Torus };
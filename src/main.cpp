@@ -1,211 +1,600 @@
 #define OLC_PGE_APPLICATION
 #include "olcPixelGameEngine.h"
 
-#include "cell.hpp"
-#include <cmath>
-#include <array>
-#include <bitset>
+#include "camera.hpp"
+#include "chunked_file.hpp"
+#include "event_stream.hpp"
+#include "frame_dump.hpp"
+#include "generators.hpp"
+#include "grid_maze.hpp"
+#include "layered_maze.hpp"
+#include "maze.hpp"
+#include "maze_arena.hpp"
+#include "maze_file.hpp"
+#include "maze_sprite.hpp"
+#include "options.hpp"
+#include "png_import.hpp"
+#include "random.hpp"
+#include "svg_export.hpp"
+#include "text_export.hpp"
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
-#include <ranges>
-#include <stack>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
-constexpr static auto COLS{30};
-constexpr static auto ROWS{20};
 constexpr static auto CELL_WIDTH{10};
 constexpr static auto CELL_HIGHT{10};
 constexpr static auto WALL_WIDTH{1};
-constexpr static auto WINDOW_WIDTH{COLS * (CELL_WIDTH + WALL_WIDTH)};
-constexpr static auto WINDOW_HIGHT{ROWS * (CELL_WIDTH + WALL_WIDTH)};
+constexpr static auto WINDOW_WIDTH{640};
+constexpr static auto WINDOW_HIGHT{480};
+constexpr static auto PIXEL_SIZE{2};
+constexpr static auto PAN_SPEED{400.0F};
+
+event_stream::Header recording_header(const Maze& maze, std::size_t goal) {
+    return {maze.wrap(),
+            static_cast<uint32_t>(maze.cols()),
+            static_cast<uint32_t>(maze.rows()),
+            static_cast<uint32_t>(goal)};
+}
+
+// Runs `write` on the export destination, - is stdout, and reports the throughput on stderr since stdout may carry
+// the export itself. `write` returns the number of bytes written or nothing on failure.
+template <typename Write>
+void export_to(const std::string& path, std::string_view format, Write&& write) {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file{nullptr, &std::fclose};
+    std::FILE* output{stdout};
+    if (path != "-") {
+        file.reset(std::fopen(path.c_str(), "wb"));
+        if (!file) {
+            std::cerr << "could not open " << path << " for the " << format << " export\n";
+            return;
+        }
+        output = file.get();
+    }
+    auto start_time{std::chrono::steady_clock::now()};
+    std::optional<std::size_t> bytes{write(output)};
+    if (output == stdout) {
+        std::fflush(stdout);
+    }
+    auto seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count()};
+    if (!bytes) {
+        std::cerr << "writing the " << format << " export failed\n";
+        return;
+    }
+    auto megabytes{static_cast<double>(*bytes) / 1e6};
+    std::cerr << "exported " << megabytes << " MB of " << format << " in " << seconds * 1e3 << " ms, "
+              << megabytes / seconds << " MB/s\n";
+}
+
+// Generation followed by the braiding pass if one is asked for, as a single stream of events.
+Generator<MazeEvent> generation(Maze& maze, const Options& options) {
+    auto events{generators::generate(maze, options.seed, options.algorithm)};
+    if (!events) {
+        co_return;
+    }
+    for (auto& event : *events) {
+        co_yield event;
+    }
+    if (options.braid > 0.0) {
+        for (auto& event : maze.braid(options.braid, options.seed)) {
+            co_yield event;
+        }
+    }
+}
+
+void save_generated(const Maze& maze, const Options& options) {
+    if (!options.save_path.empty() && !save_maze(maze, options.save_path)) {
+        std::cerr << "could not save the maze to " << options.save_path << "\n";
+    }
+    if (!options.save_chunked_path.empty() && !save_chunked(maze, options.save_chunked_path)) {
+        std::cerr << "could not save the maze to " << options.save_chunked_path << "\n";
+    }
+    if (!options.text_path.empty()) {
+        export_to(options.text_path, "text", [&](std::FILE* output) {
+            return TextExporter(maze.walls(), (options.unicode) ? TextStyle::Unicode : TextStyle::Ascii).write(output);
+        });
+    }
+    if (!options.svg_path.empty()) {
+        export_to(options.svg_path, "SVG", [&](std::FILE* output) -> std::optional<std::size_t> {
+            auto summary{SvgExporter(maze.walls(), CELL_WIDTH).write(output)};
+            if (!summary) {
+                return std::nullopt;
+            }
+            std::cerr << "merged " << summary->walls << " walls into " << summary->segments << " segments\n";
+            return summary->bytes;
+        });
+    }
+}
 
 class MazeGenerator : public olc::PixelGameEngine {
+    enum class Phase { Generating, Solving, Replaying, Done };
 
   public:
-    MazeGenerator(int32_t cols, int32_t rows, int32_t cell_width, int32_t cell_height) :
-        m_cols(cols), m_rows(rows), m_goal(7, 20, cell_width, cell_height) {
+    MazeGenerator(Maze& maze, const Options& options, std::size_t goal, EventReplayer* replayer) :
+        m_maze(maze),
+        m_options(options),
+        m_camera(CELL_WIDTH + WALL_WIDTH, CELL_HIGHT + WALL_WIDTH, WINDOW_WIDTH, WINDOW_HIGHT),
+        m_steps_per_frame(options.steps_per_frame),
+        m_goal(goal),
+        m_replayer(replayer) {
         sAppName.assign("MazeGenerator");
-        m_grid.reserve(cols * rows);
-        for (int32_t row : std::views::iota(int32_t(0), m_rows)) {
-            for (int32_t col : std::views::iota(int32_t(0), m_cols)) {
-                m_grid.emplace_back(col, row, cell_width, cell_height);
-            }
+        if (!options.record_path.empty() && !m_recorder.open(options.record_path, recording_header(m_maze, m_goal))) {
+            std::cerr << "could not open " << options.record_path << " for recording\n";
         }
     }
 
     bool OnUserCreate() override {
-        srand(static_cast<unsigned>(time(0)));
-        cell_at(0, 0).set_visited();
-        visitor.push(&cell_at(0, 0));
-
-        open_set.push_back(&cell_at(0, 0));
-        m_goal = m_grid.at(rand() % m_grid.size());
-        m_goal.set_visited();
-        cell_at(0, 0).m_f_score = heuristic(cell_at(0, 0), m_goal);
-        cell_at(0, 0).m_g_score = 0;
-        draw(this);
+        if (m_replayer) {
+            m_phase = Phase::Replaying;
+            m_steps = m_maze.replay(m_replayer->events());
+        } else if (m_maze.is_generated()) {
+            m_phase = Phase::Solving;
+            m_steps = m_maze.solve(m_maze.start(), m_goal);
+        } else {
+            m_steps = generation(m_maze, m_options);
+        }
+        if (MazeSprite::fits(m_maze, CELL_WIDTH, CELL_HIGHT)) {
+            m_sprite = std::make_unique<MazeSprite>(m_maze, CELL_WIDTH, CELL_HIGHT);
+        }
+        m_camera.fit(static_cast<int32_t>(m_maze.cols()), static_cast<int32_t>(m_maze.rows()));
         return true;
     }
 
     bool OnUserUpdate(float elapsed_time) override {
-        if (!visitor.empty()) {
-            //     // generate maze
-            draw(this);
-            auto& current_cell = visitor.top();
-            current_cell->draw(this, olc::GREEN);
-
-            auto unvisited_neighbours = get_unvisited_neighbours(current_cell->m_x, current_cell->m_y);
-            if (!unvisited_neighbours.empty()) {
-                auto [random_neighbour_direction, random_neighbour] =
-                    unvisited_neighbours.at(rand() % unvisited_neighbours.size());
-                random_neighbour.set_visited();
-                visitor.push(&random_neighbour);
-                switch (random_neighbour_direction) {
-                    case Direction::North: {
-                        random_neighbour.remove_wall(Direction::South);
-                        current_cell->remove_wall(Direction::North);
-                    } break;
-                    case Direction::East: {
-                        random_neighbour.remove_wall(Direction::West);
-                        current_cell->remove_wall(Direction::East);
-                    } break;
-                    case Direction::West: {
-                        random_neighbour.remove_wall(Direction::East);
-                        current_cell->remove_wall(Direction::West);
-                    } break;
-                    case Direction::South: {
-                        random_neighbour.remove_wall(Direction::North);
-                        current_cell->remove_wall(Direction::South);
-                    } break;
-                    default:
-                        break;
-                }
-            } else {
-                visitor.pop();
-            }
-        } else {
-            // solve maze
-            if (!open_set.empty()) {
-                auto current_best_cell = open_set.front();
-                current_best_cell->draw(this, olc::MAGENTA);
-                m_goal.draw(this, olc::RED);
-                if (current_best_cell->m_x == m_goal.m_x && current_best_cell->m_y == m_goal.m_y) {
-                    reconstrucs_path({current_best_cell->m_x, current_best_cell->m_y});
-                    return true;
-                }
+        handle_input(elapsed_time);
 
-                std::ranges::pop_heap(open_set);
-                open_set.pop_back();
-                auto neighbours = get_neighbours(current_best_cell->m_x, current_best_cell->m_y);
-                for (auto& neighbour : neighbours) {
-                    auto tentative_gScore = current_best_cell->m_g_score + 1;
-                    if (tentative_gScore < neighbour->m_g_score) {
-
-                        m_came_from.insert(
-                            {{neighbour->m_x, neighbour->m_y}, {current_best_cell->m_x, current_best_cell->m_y}});
-                        neighbour->m_g_score = tentative_gScore;
-                        neighbour->m_f_score = tentative_gScore + heuristic(*neighbour, m_goal);
-
-                        if (open_set.end() == std::ranges::find_if(open_set, [&](Cell*& cell) {
-                                return cell->m_x == neighbour->m_x && cell->m_y == neighbour->m_y;
-                            })) {
-
-                            open_set.push_back(neighbour);
-                            std::ranges::push_heap(open_set,
-                                                   [&](auto c1, auto c2) { return c1->m_f_score < c2->m_f_score; });
-                        }
-                    }
-                }
+        for (int32_t step = 0; step < m_steps_per_frame && m_phase != Phase::Done; ++step) {
+            if (!m_steps.next()) {
+                next_phase();
+                continue;
+            }
+            m_last_event = m_steps.value();
+            if (m_recorder.is_open()) {
+                m_recorder.record(m_last_event);
+            }
+            if (m_sprite) {
+                m_sprite->apply(m_last_event);
+            }
+            if (m_last_event.kind == MazeEvent::Kind::Path) {
+                m_path.push_back(m_last_event);
             }
         }
 
+        Clear(olc::BLACK);
+        if (m_sprite) {
+            m_sprite->update();
+        }
+        if (m_sprite && !m_camera.is_overview()) {
+            m_sprite->draw(this, m_camera);
+        } else {
+            m_maze.draw(this, m_camera);
+        }
+        draw_cell(m_goal, olc::RED);
+        if (m_phase != Phase::Done) {
+            auto generating{m_last_event.kind == MazeEvent::Kind::Carve ||
+                            m_last_event.kind == MazeEvent::Kind::Backtrack};
+            draw_cell(m_last_event.index, (generating) ? olc::GREEN : olc::MAGENTA);
+        }
+        draw_path();
         return true;
     }
 
   private:
-    void draw(olc::PixelGameEngine* pge) {
-        for (auto& cell : m_grid) {
-            cell.draw(pge);
+    void next_phase() {
+        if (m_phase == Phase::Generating) {
+            save_generated(m_maze, m_options);
+            m_phase = Phase::Solving;
+            m_steps = m_maze.solve(m_maze.start(), m_goal);
+        } else {
+            m_phase = Phase::Done;
+            m_recorder.close();
         }
     }
 
-    Cell& cell_at(int32_t row, int32_t col) {
-        return m_grid.at(index_from(row, col));
-    }
-
-    std::vector<Cell*> get_neighbours(int32_t col, int32_t row) {
-        std::vector<Cell*> neighbours;
-        auto& cell = cell_at(row, col);
-        if (!cell.has_wall(Direction::North)) {
-            neighbours.emplace_back(&cell_at(row - 1, col));
+    void handle_input(float elapsed_time) {
+        auto pan_step{PAN_SPEED * elapsed_time};
+        if (GetKey(olc::Key::LEFT).bHeld || GetKey(olc::Key::A).bHeld) {
+            m_camera.pan(-pan_step, 0.0F);
         }
-        if (!cell.has_wall(Direction::East)) {
-            neighbours.emplace_back(&cell_at(row, col + 1));
+        if (GetKey(olc::Key::RIGHT).bHeld || GetKey(olc::Key::D).bHeld) {
+            m_camera.pan(pan_step, 0.0F);
         }
-        if (!cell.has_wall(Direction::South)) {
-            neighbours.emplace_back(&cell_at(row + 1, col));
+        if (GetKey(olc::Key::UP).bHeld || GetKey(olc::Key::W).bHeld) {
+            m_camera.pan(0.0F, -pan_step);
         }
-        if (!cell.has_wall(Direction::West)) {
-            neighbours.emplace_back(&cell_at(row, col - 1));
+        if (GetKey(olc::Key::DOWN).bHeld || GetKey(olc::Key::S).bHeld) {
+            m_camera.pan(0.0F, pan_step);
         }
 
-        return neighbours;
-    }
+        // drag with the left mouse button
+        if (GetMouse(0).bHeld && !GetMouse(0).bPressed) {
+            m_camera.pan(static_cast<float>(m_mouse_x - GetMouseX()), static_cast<float>(m_mouse_y - GetMouseY()));
+        }
+        m_mouse_x = GetMouseX();
+        m_mouse_y = GetMouseY();
 
-    std::vector<std::pair<Direction, Cell&>> get_unvisited_neighbours(int32_t col, int32_t row) {
-        std::vector<std::pair<Direction, Cell&>> neighbours;
-        if (row > 0 && !cell_at(row - 1, col).is_visited()) {
-            neighbours.emplace_back(Direction::North, cell_at(row - 1, col));
+        auto wheel{GetMouseWheel()};
+        if (wheel != 0) {
+            m_camera.zoom((wheel > 0) ? 1 : -1, m_mouse_x, m_mouse_y);
         }
-        if (col < m_cols - 1 && !cell_at(row, col + 1).is_visited()) {
-            neighbours.emplace_back(Direction::East, cell_at(row, col + 1));
+        if (GetKey(olc::Key::PGUP).bPressed || GetKey(olc::Key::NP_ADD).bPressed) {
+            m_camera.zoom(1, ScreenWidth() / 2, ScreenHeight() / 2);
         }
-        if (row < m_rows - 1 && !cell_at(row + 1, col).is_visited()) {
-            neighbours.emplace_back(Direction::South, cell_at(row + 1, col));
+        if (GetKey(olc::Key::PGDN).bPressed || GetKey(olc::Key::NP_SUB).bPressed) {
+            m_camera.zoom(-1, ScreenWidth() / 2, ScreenHeight() / 2);
         }
-        if (col > 0 && !cell_at(row, col - 1).is_visited()) {
-            neighbours.emplace_back(Direction::West, cell_at(row, col - 1));
+        if (GetKey(olc::Key::HOME).bPressed) {
+            m_camera.fit(static_cast<int32_t>(m_maze.cols()), static_cast<int32_t>(m_maze.rows()));
         }
+    }
 
-        return neighbours;
+    void draw_cell(std::size_t index, olc::Pixel color) {
+        m_maze.cell(index).draw(this, m_camera, color);
     }
 
-    int32_t index_from(int32_t row, int32_t col) {
-        return col + row * m_cols;
+    void draw_path() {
+        for (auto& event : m_path) {
+            auto current{m_maze.cell(event.index)};
+            auto previous{m_maze.cell(m_maze.neighbour_index(event.index, event.direction))};
+            auto [x1, y1] = m_camera.to_screen_center(current.m_x, current.m_y, CELL_WIDTH, CELL_HIGHT);
+            auto [x2, y2] = m_camera.to_screen_center(previous.m_x, previous.m_y, CELL_WIDTH, CELL_HIGHT);
+            DrawLine(x1, y1, x2, y2, olc::YELLOW);
+        }
     }
 
-    double heuristic(Cell& cell, Cell& goal) {
-        return std::abs(cell.m_x - goal.m_x) * std::abs(cell.m_y - goal.m_y);
+  private:
+    Maze& m_maze;
+    const Options& m_options;
+    std::unique_ptr<MazeSprite> m_sprite;
+    Camera m_camera;
+    int32_t m_mouse_x{0};
+    int32_t m_mouse_y{0};
+
+    // the running algorithm, advanced by `m_steps_per_frame` steps each frame
+    Phase m_phase{Phase::Generating};
+    Generator<MazeEvent> m_steps;
+    int32_t m_steps_per_frame;
+    MazeEvent m_last_event;
+
+    std::size_t m_goal;
+    std::vector<MazeEvent> m_path;
+
+    EventRecorder m_recorder;
+    EventReplayer* m_replayer;
+};
+
+// Drains both algorithms (or the replayed events) at full speed without opening a window.
+int run_headless(Maze& maze, const Options& options, std::size_t goal, EventReplayer* replayer) {
+    EventRecorder recorder;
+    if (!options.record_path.empty() && !recorder.open(options.record_path, recording_header(maze, goal))) {
+        std::cerr << "could not open " << options.record_path << " for recording\n";
+        return 1;
     }
 
-    void reconstrucs_path(std::pair<int32_t, int32_t> current) {
-        while (m_came_from.contains(current)) {
-            std::pair<int32_t, int32_t> previous = m_came_from.at(current);
-            DrawLine((current.first * (CELL_WIDTH + WALL_WIDTH)) + CELL_WIDTH / 2,
-                     (current.second * (CELL_HIGHT + WALL_WIDTH)) + CELL_HIGHT / 2,
-                     (previous.first * (CELL_WIDTH + WALL_WIDTH)) + CELL_WIDTH / 2,
-                     (previous.second * (CELL_HIGHT + WALL_WIDTH)) + CELL_HIGHT / 2,
-                     olc::YELLOW);
-            current = previous;
+    // the stream goes to stdout unless a file or named pipe is given, the report then moves to stderr
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> dump_file{nullptr, &std::fclose};
+    std::FILE* dump_output{stdout};
+    if (options.dump_every > 0 && options.dump_path != "-") {
+        dump_file.reset(std::fopen(options.dump_path.c_str(), "wb"));
+        if (!dump_file) {
+            std::cerr << "could not open " << options.dump_path << " for the frame dump\n";
+            return 1;
         }
+        dump_output = dump_file.get();
+    }
+    std::unique_ptr<FrameDumper> dumper;
+    if (options.dump_every > 0) {
+        dumper = std::make_unique<FrameDumper>(maze, CELL_WIDTH, CELL_HIGHT, dump_output);
     }
+    auto stdout_taken{(dumper && !dump_file) || options.text_path == "-" || options.svg_path == "-"};
+    auto& report{(stdout_taken) ? std::cerr : std::cout};
 
-  private:
-    int32_t m_cols;
-    int32_t m_rows;
-    std::vector<Cell> m_grid;
+    auto drain = [&](Generator<MazeEvent> steps) {
+        std::size_t count{0};
+        for (auto& event : steps) {
+            if (recorder.is_open()) {
+                recorder.record(event);
+            }
+            ++count;
+            if (dumper) {
+                dumper->apply(event);
+                if (count % static_cast<std::size_t>(options.dump_every) == 0) {
+                    dumper->write_frame();
+                }
+            }
+        }
+        return count;
+    };
+
+    auto start_time{std::chrono::steady_clock::now()};
+    std::size_t generation_steps{0};
+    if (replayer) {
+        generation_steps = drain(maze.replay(replayer->events()));
+    } else if (!maze.is_generated()) {
+        generation_steps = drain(generation(maze, options));
+        save_generated(maze, options);
+    }
+    auto generated_time{std::chrono::steady_clock::now()};
+    auto solving_steps{drain((replayer) ? Generator<MazeEvent>{} : maze.solve(maze.start(), goal))};
+    auto solved_time{std::chrono::steady_clock::now()};
+    if (dumper && !dumper->write_frame()) {
+        std::cerr << "writing the frame dump failed\n";
+        return 1;
+    }
 
-    // generating the maze
-    std::stack<Cell*> visitor;
+    auto to_ms = [](auto duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+    if (replayer) {
+        report << "replayed " << maze.cols() << "x" << maze.rows() << " in " << generation_steps << " steps, "
+               << to_ms(generated_time - start_time) << " ms\n";
+        return 0;
+    }
+    if (maze.is_generated()) {
+        report << "loaded " << maze.cols() << "x" << maze.rows() << " (seed " << maze.seed() << ")\n";
+    } else {
+        report << "generated " << maze.cols() << "x" << maze.rows() << " (seed " << maze.seed() << ") in "
+               << generation_steps << " steps, " << to_ms(generated_time - start_time) << " ms, "
+               << maze.count_dead_ends() << " dead ends\n";
+    }
+    report << "solved in " << solving_steps << " steps, " << to_ms(solved_time - generated_time) << " ms";
+    if (auto cost{maze.path_cost(goal)}) {
+        report << ", path cost " << *cost;
+    }
+    report << "\n";
+    return 0;
+}
 
-    // solving the maze
-    std::vector<Cell*> open_set;
-    std::map<std::pair<int32_t, int32_t>, std::pair<int32_t, int32_t>> m_came_from;
-    Cell m_goal;
-};
+// Generates and solves a maze of hex or triangle cells, these have no renderer or file format yet.
+template <typename Topology>
+int run_topology(const Options& options) {
+    GridMaze<Topology> maze(static_cast<std::size_t>(options.cols), static_cast<std::size_t>(options.rows));
+    auto goal{Random(~options.seed).below(maze.size())};
+    auto drain = [](Generator<GridEvent> steps) {
+        std::size_t count{0};
+        for ([[maybe_unused]] auto& event : steps) {
+            ++count;
+        }
+        return count;
+    };
+
+    auto start_time{std::chrono::steady_clock::now()};
+    auto generation_steps{drain(maze.generate(options.seed))};
+    auto generated_time{std::chrono::steady_clock::now()};
+    auto solving_steps{drain(maze.solve(0, goal))};
+    auto solved_time{std::chrono::steady_clock::now()};
+
+    auto to_ms = [](auto duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+    std::cout << "generated " << options.topology << " " << maze.cols() << "x" << maze.rows() << " (seed "
+              << options.seed << ") in " << generation_steps << " steps, " << to_ms(generated_time - start_time)
+              << " ms\n";
+    std::cout << "solved in " << solving_steps << " steps, " << to_ms(solved_time - generated_time) << " ms\n";
+    return 0;
+}
+
+// Generates a layered maze, straight to disk when a file is given, and solves it from the first to the last layer.
+int run_layered(const Options& options) {
+    auto cols{static_cast<std::size_t>(options.cols)};
+    auto rows{static_cast<std::size_t>(options.rows)};
+    auto layers{static_cast<std::size_t>(options.layers)};
+    LayeredMaze maze;
+    auto start_time{std::chrono::steady_clock::now()};
+    if (options.layers_path.empty()) {
+        maze.generate(cols, rows, layers, options.seed);
+    } else if (!save_layers(options.layers_path, cols, rows, layers, options.seed) || !maze.open(options.layers_path)) {
+        std::cerr << "could not write the layers to " << options.layers_path << "\n";
+        return 1;
+    }
+    auto generated_time{std::chrono::steady_clock::now()};
+    auto goal{maze.size() - 1 - Random(~options.seed).below(cols * rows)};
+    auto distance{maze.distance(0, goal)};
+    auto solved_time{std::chrono::steady_clock::now()};
+
+    auto to_ms = [](auto duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+    std::cout << "generated " << cols << "x" << rows << "x" << layers << " (seed " << options.seed << ") in "
+              << to_ms(generated_time - start_time) << " ms\n";
+    if (!distance) {
+        std::cout << "goal not reachable\n";
+        return 1;
+    }
+    std::cout << "solved, " << *distance << " steps to the last layer, " << to_ms(solved_time - generated_time)
+              << " ms\n";
+    return 0;
+}
+
+// Times every generator on a maze of the given size, best of a few runs each, and reports the scratch memory it needed
+// besides the maze. Writing the wall planes without any algorithm comes first as the bound set by the memory bandwidth.
+int run_benchmark(const Options& options) {
+    constexpr static auto RUNS{3};
+    auto cols{static_cast<std::size_t>(options.cols)};
+    auto rows{static_cast<std::size_t>(options.rows)};
+    auto threads{static_cast<std::size_t>(options.threads)};
+    auto wall_bytes{2.0 * static_cast<double>(BitPlane::words_per_row(cols) * rows * sizeof(uint64_t))};
+    auto cells{static_cast<double>(cols * rows)};
+    std::cout << "benchmark " << cols << "x" << rows << " (seed " << options.seed << "), " << threads << " threads\n";
+
+    auto time = [&](std::string_view name, auto&& run) {
+        auto best{std::numeric_limits<double>::max()};
+        std::size_t scratch{0};
+        for (int i = 0; i < RUNS; ++i) {
+            Maze maze(cols, rows, 1, 1);
+            auto start_time{std::chrono::steady_clock::now()};
+            run(maze);
+            auto end_time{std::chrono::steady_clock::now()};
+            best = std::min(best, std::chrono::duration<double, std::milli>(end_time - start_time).count());
+            scratch = maze.generation_scratch();
+        }
+        std::cout << "  " << name << ": " << best << " ms, " << cells / best / 1e3 << " Mcells/s, "
+                  << wall_bytes / best / 1e6 << " GB/s of walls, " << scratch / 1024 << " KiB peak scratch\n";
+    };
+    auto drain = [&](Generator<MazeEvent> steps) {
+        for ([[maybe_unused]] auto& event : steps) {
+        }
+    };
+
+    WallGrid walls(cols, rows);
+    time("fill walls", [&](Maze&) {
+        std::fill_n(walls.east().data(), walls.east().word_count(), 0);
+        std::fill_n(walls.south().data(), walls.south().word_count(), 0);
+    });
+    for (const auto& entry : generators::ENTRIES) {
+        time(entry.name, [&](Maze& maze) { drain(*generators::generate(maze, options.seed, entry.algorithm)); });
+        if (entry.carve) {
+            time(std::string(entry.name) + ", 1 thread",
+                 [&](Maze& maze) { generators::carve(maze, options.seed, entry.algorithm, 1); });
+            time(std::string(entry.name) + ", " + std::to_string(threads) + " threads",
+                 [&](Maze& maze) { generators::carve(maze, options.seed, entry.algorithm, threads); });
+        }
+    }
+
+    // the same cells as many small mazes, each built on its own and all of them in one arena
+    constexpr static std::size_t BATCH_SIDE{16};
+    auto batch{std::max<std::size_t>(cols * rows / (BATCH_SIDE * BATCH_SIDE), 1)};
+    auto batch_name{std::to_string(batch) + " backtracker mazes of " + std::to_string(BATCH_SIDE) + "x" +
+                    std::to_string(BATCH_SIDE)};
+    time(batch_name + ", one by one", [&](Maze&) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            Maze small(BATCH_SIDE, BATCH_SIDE, 1, 1);
+            drain(small.generate(options.seed + i));
+        }
+    });
+    MazeArena arena(1, 1);
+    time(batch_name + ", in an arena", [&](Maze&) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            arena.generate(BATCH_SIDE, BATCH_SIDE, options.seed + i);
+        }
+    });
+    return 0;
+}
 
 int main(int argc, char const* argv[]) {
-    MazeGenerator maze_generator(COLS, ROWS, CELL_WIDTH, CELL_HIGHT);
-    if (maze_generator.Construct(WINDOW_WIDTH, WINDOW_HIGHT, 4, 4)) {
+    auto options{parse_options(argc, argv)};
+    if (!options) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (options->bench) {
+        return run_benchmark(*options);
+    }
+    if (options->topology != "square" || options->layers > 0) {
+        if (!options->has_seed) {
+            options->seed = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+        }
+        if (options->layers > 0) {
+            return run_layered(*options);
+        }
+        return (options->topology == "hex") ? run_topology<HexTopology>(*options)
+                                            : run_topology<TriangleTopology>(*options);
+    }
+
+    EventReplayer replayer;
+    MappedMaze mapped;
+    std::unique_ptr<Maze> owned;
+    Maze* maze{nullptr};
+    std::size_t goal{0};
+    if (!options->replay_path.empty()) {
+        if (!replayer.open(options->replay_path)) {
+            std::cerr << "could not replay " << options->replay_path << "\n";
+            return 1;
+        }
+        const auto& header{replayer.header()};
+        owned = std::make_unique<Maze>(header.cols, header.rows, CELL_WIDTH, CELL_HIGHT, header.wrap);
+        maze = owned.get();
+        goal = replayer.header().goal;
+    } else {
+        if (!options->has_seed) {
+            options->seed = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+        }
+        if (!options->load_path.empty()) {
+            if (!mapped.open(options->load_path, CELL_WIDTH, CELL_HIGHT)) {
+                std::cerr << "could not load " << options->load_path << "\n";
+                return 1;
+            }
+            maze = &mapped.maze();
+        } else if (!options->load_chunked_path.empty()) {
+            ChunkedMazeReader reader;
+            if (reader.open(options->load_chunked_path)) {
+                owned = reader.load(CELL_WIDTH, CELL_HIGHT);
+            }
+            if (!owned) {
+                std::cerr << "could not load " << options->load_chunked_path << "\n";
+                return 1;
+            }
+            maze = owned.get();
+        } else if (!options->png_path.empty()) {
+            PngImporter importer;
+            std::optional<WallGrid> walls;
+            if (importer.open(options->png_path)) {
+                walls = importer.walls(static_cast<uint32_t>(options->png_pitch));
+            }
+            if (!walls) {
+                std::cerr << "could not import " << options->png_path << " with a pitch of " << options->png_pitch
+                          << "\n";
+                return 1;
+            }
+            owned = std::make_unique<Maze>(std::move(*walls), CELL_WIDTH, CELL_HIGHT, 0, Algorithm::Imported);
+            maze = owned.get();
+        } else if (!options->mask_path.empty()) {
+            if (options->wrap != Wrap::None) {
+                std::cerr << "a mask can't wrap, its edges are not joined\n";
+                return 1;
+            }
+            PngImporter importer;
+            std::optional<BitPlane> mask;
+            if (importer.open(options->mask_path)) {
+                mask = importer.mask();
+            }
+            if (!mask) {
+                std::cerr << "could not read a mask from " << options->mask_path << "\n";
+                return 1;
+            }
+            if (!generators::find(options->algorithm).grows_from_start) {
+                std::cerr << "only the generators growing from the start cell generate within a mask\n";
+                return 1;
+            }
+            owned = std::make_unique<Maze>(std::move(*mask), CELL_WIDTH, CELL_HIGHT);
+            maze = owned.get();
+        } else {
+            owned = std::make_unique<Maze>(options->cols, options->rows, CELL_WIDTH, CELL_HIGHT, options->wrap);
+            maze = owned.get();
+        }
+        // the goal has to be a cell the generation visits, with a mask that's only the part connected to the start
+        Random random(~options->seed);
+        if (maze->is_masked()) {
+            auto reachable{maze->reachable()};
+            goal = reachable.nth_set(random.below(reachable.count()));
+        } else {
+            goal = random.below(maze->size());
+        }
+        if (!options->costs_path.empty()) {
+            PngImporter importer;
+            std::optional<std::vector<uint8_t>> costs;
+            if (importer.open(options->costs_path)) {
+                costs = importer.costs(maze->cols(), maze->rows());
+            }
+            if (!costs || !maze->set_costs(std::move(*costs))) {
+                std::cerr << "could not read " << maze->cols() << "x" << maze->rows() << " costs from "
+                          << options->costs_path << "\n";
+                return 1;
+            }
+        }
+    }
+    auto* events{(options->replay_path.empty()) ? nullptr : &replayer};
+
+    if (options->headless) {
+        return run_headless(*maze, *options, goal, events);
+    }
+    MazeGenerator maze_generator(*maze, *options, goal, events);
+    if (maze_generator.Construct(WINDOW_WIDTH, WINDOW_HIGHT, PIXEL_SIZE, PIXEL_SIZE)) {
         maze_generator.Start();
     }
     return 0;
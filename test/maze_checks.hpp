@@ -0,0 +1,69 @@
+#pragma once
+
+#include "maze.hpp"
+#include <cstdint>
+#include <vector>
+
+// Checks on the walls of square mazes shared by the tests.
+namespace maze_checks {
+inline bool same_walls(const Maze& a, const Maze& b) {
+    if (a.cols() != b.cols() || a.rows() != b.rows() || a.wrap() != b.wrap()) {
+        return false;
+    }
+    for (std::size_t index = 0; index < a.size(); ++index) {
+        for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+            if (a.has_wall(index, direction) != b.has_wall(index, direction)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Passages of the maze, every cell counts its east and south wall.
+inline std::size_t passages(const Maze& maze) {
+    std::size_t count{0};
+    for (std::size_t index = 0; index < maze.size(); ++index) {
+        count += !maze.has_wall(index, Direction::East);
+        count += !maze.has_wall(index, Direction::South);
+    }
+    return count;
+}
+
+// Whether the passages form a tree spanning exactly the cells connected to the start, every cell of an unmasked maze.
+inline bool is_perfect(const Maze& maze) {
+    auto reachable{maze.reachable()};
+    std::vector<bool> reached(maze.size(), false);
+    std::vector<std::size_t> stack{maze.start()};
+    std::size_t count{1};
+    reached[maze.start()] = true;
+    while (!stack.empty()) {
+        auto current{stack.back()};
+        stack.pop_back();
+        for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+            if (maze.has_wall(current, direction)) {
+                continue;
+            }
+            auto neighbour{maze.neighbour_index(current, direction)};
+            if (!reached[neighbour]) {
+                reached[neighbour] = true;
+                ++count;
+                stack.push_back(neighbour);
+            }
+        }
+    }
+    for (std::size_t index = 0; index < maze.size(); ++index) {
+        if (reached[index] != reachable.test(index % maze.cols(), index / maze.cols())) {
+            return false;
+        }
+    }
+    return passages(maze) == count - 1;
+}
+
+// Runs a generator's events to the end.
+template <typename Events>
+void drain(Events&& events) {
+    for ([[maybe_unused]] auto& event : events) {
+    }
+}
+} // namespace maze_checks
@@ -0,0 +1,53 @@
+#include "catch.hpp"
+#include "maze_checks.hpp"
+
+namespace {
+// Dead ends counted cell by cell, the cells with exactly three walls.
+std::size_t dead_ends(const Maze& maze) {
+    std::size_t count{0};
+    for (std::size_t index = 0; index < maze.size(); ++index) {
+        std::size_t walls{0};
+        for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+            walls += maze.has_wall(index, direction);
+        }
+        count += walls == 3;
+    }
+    return count;
+}
+} // namespace
+
+TEST_CASE("dead ends are counted a word at a time", "[braid]") {
+    for (auto wrap : {Wrap::None, Wrap::Cylinder, Wrap::Torus}) {
+        Maze maze(130, 9, 1, 1, wrap);
+        maze_checks::drain(maze.prim(1));
+        CHECK(maze.count_dead_ends() == dead_ends(maze));
+        maze_checks::drain(maze.braid(0.5, 1));
+        CHECK(maze.count_dead_ends() == dead_ends(maze));
+    }
+}
+
+TEST_CASE("braiding removes the fraction of dead ends it is asked to", "[braid]") {
+    for (auto wrap : {Wrap::None, Wrap::Torus}) {
+        for (double fraction : {0.0, 0.25, 0.5, 1.0}) {
+            INFO("fraction " << fraction << " wrap " << static_cast<int>(wrap));
+            Maze maze(40, 30, 1, 1, wrap);
+            maze_checks::drain(maze.generate(2));
+            auto before{maze.count_dead_ends()};
+            auto passages{maze_checks::passages(maze)};
+            std::size_t carved{0};
+            for (auto event : maze.braid(fraction, 3)) {
+                CHECK(event.kind == MazeEvent::Kind::Carve);
+                ++carved;
+            }
+            // every knocked out wall is a new passage ending one or two picked dead ends, none of which is left
+            auto picked{static_cast<std::size_t>(fraction * static_cast<double>(before))};
+            CHECK(carved <= picked);
+            CHECK(2 * carved >= picked);
+            CHECK(maze_checks::passages(maze) == passages + carved);
+            CHECK(maze.count_dead_ends() <= before - picked);
+            if (fraction == 1.0) {
+                CHECK(maze.count_dead_ends() == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#include "catch.hpp"
+#include "chunked_file.hpp"
+#include "maze_checks.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace {
+std::string file_path() {
+    return (std::filesystem::temp_directory_path() / "test_chunked_file.mzc").string();
+}
+} // namespace
+
+TEST_CASE("chunked file loads the walls it was saved with", "[chunked_file]") {
+    for (auto wrap : {Wrap::None, Wrap::Cylinder, Wrap::Torus}) {
+        Maze maze(75, 50, 1, 1, wrap);
+        maze_checks::drain(maze.generate(6));
+        REQUIRE(save_chunked(maze, file_path(), 16));
+
+        ChunkedMazeReader reader;
+        REQUIRE(reader.open(file_path()));
+        auto loaded{reader.load(1, 1)};
+        REQUIRE(loaded);
+        CHECK(loaded->seed() == 6);
+        CHECK(loaded->algorithm() == maze.algorithm());
+        CHECK(maze_checks::same_walls(*loaded, maze));
+        CHECK(reader.chunks_decoded() == 5 * 4);
+    }
+    std::filesystem::remove(file_path());
+}
+
+TEST_CASE("chunked file regions match the walls of the full maze", "[chunked_file]") {
+    Maze maze(75, 50, 1, 1);
+    maze_checks::drain(maze.generate(7));
+    REQUIRE(save_chunked(maze, file_path(), 16));
+    ChunkedMazeReader reader;
+    REQUIRE(reader.open(file_path()));
+
+    struct Region {
+        std::size_t first_col, first_row, cols, rows, chunks;
+    };
+    for (auto [first_col, first_row, cols, rows, chunks] : {Region{0, 0, 75, 50, 20},
+                                                            Region{16, 16, 16, 16, 1},
+                                                            Region{15, 31, 2, 2, 4},
+                                                            Region{70, 45, 5, 5, 2},
+                                                            Region{3, 40, 60, 1, 4}}) {
+        auto decoded{reader.chunks_decoded()};
+        auto region{reader.read_region(first_col, first_row, cols, rows)};
+        REQUIRE(region);
+        CHECK(reader.chunks_decoded() - decoded == chunks);
+        bool same{true};
+        for (std::size_t row = 0; row < rows; ++row) {
+            for (std::size_t col = 0; col < cols; ++col) {
+                same = same &&
+                       region->east().test(col, row) == maze.walls().east().test(first_col + col, first_row + row) &&
+                       region->south().test(col, row) == maze.walls().south().test(first_col + col, first_row + row);
+            }
+        }
+        CHECK(same);
+    }
+    CHECK_FALSE(reader.read_region(0, 0, 0, 1));
+    CHECK_FALSE(reader.read_region(70, 0, 6, 1));
+    CHECK_FALSE(reader.read_region(0, 45, 1, 6));
+    CHECK_FALSE(reader.read_region(SIZE_MAX, 0, 2, 1));
+    CHECK_FALSE(reader.read_region(0, 1, 1, SIZE_MAX));
+    std::filesystem::remove(file_path());
+}
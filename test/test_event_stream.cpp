@@ -0,0 +1,78 @@
+#include "catch.hpp"
+#include "event_stream.hpp"
+#include "maze.hpp"
+#include <filesystem>
+#include <vector>
+
+namespace {
+std::string stream_path() {
+    return (std::filesystem::temp_directory_path() / "test_event_stream.events").string();
+}
+
+std::vector<MazeEvent> replay(const std::string& path) {
+    EventReplayer replayer;
+    REQUIRE(replayer.open(path));
+    std::vector<MazeEvent> events;
+    for (auto& event : replayer.events()) {
+        events.push_back(event);
+    }
+    return events;
+}
+} // namespace
+
+TEST_CASE("event stream replays a recorded generation onto the same walls", "[event_stream]") {
+    for (auto wrap : {Wrap::None, Wrap::Cylinder, Wrap::Torus}) {
+        Maze maze(9, 7, 1, 1, wrap);
+        {
+            EventRecorder recorder;
+            REQUIRE(recorder.open(stream_path(), {wrap, 9, 7, 62}));
+            for (auto& event : maze.generate(11)) {
+                recorder.record(event);
+            }
+        }
+
+        EventReplayer replayer;
+        REQUIRE(replayer.open(stream_path()));
+        CHECK(replayer.header().wrap == wrap);
+        CHECK(replayer.header().goal == 62);
+        Maze replayed(9, 7, 1, 1, replayer.header().wrap);
+        for (auto& event : replayer.events()) {
+            replayed.apply(event);
+        }
+        for (std::size_t index = 0; index < maze.size(); ++index) {
+            for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+                CHECK(replayed.has_wall(index, direction) == maze.has_wall(index, direction));
+            }
+        }
+    }
+    std::filesystem::remove(stream_path());
+}
+
+TEST_CASE("event stream ends at a step leading out of the maze", "[event_stream]") {
+    auto record = [](Wrap wrap, MazeEvent bad) {
+        EventRecorder recorder;
+        REQUIRE(recorder.open(stream_path(), {wrap, 4, 3, 0}));
+        recorder.record({MazeEvent::Kind::Carve, Direction::East, 0});
+        recorder.record({MazeEvent::Kind::Expand, Direction::NUM, 1});
+        recorder.record(bad);
+        recorder.record({MazeEvent::Kind::Carve, Direction::South, 1});
+    };
+
+    SECTION("a path step without a direction") {
+        record(Wrap::None, {MazeEvent::Kind::Path, Direction::NUM, 5});
+        CHECK(replay(stream_path()).size() == 2);
+    }
+    SECTION("a carve across an edge that isn't joined") {
+        record(Wrap::None, {MazeEvent::Kind::Carve, Direction::West, 4});
+        CHECK(replay(stream_path()).size() == 2);
+        record(Wrap::Cylinder, {MazeEvent::Kind::Path, Direction::North, 2});
+        CHECK(replay(stream_path()).size() == 2);
+    }
+    SECTION("steps across joined edges replay") {
+        record(Wrap::Cylinder, {MazeEvent::Kind::Carve, Direction::West, 4});
+        CHECK(replay(stream_path()).size() == 4);
+        record(Wrap::Torus, {MazeEvent::Kind::Path, Direction::North, 2});
+        CHECK(replay(stream_path()).size() == 4);
+    }
+    std::filesystem::remove(stream_path());
+}
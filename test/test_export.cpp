@@ -0,0 +1,94 @@
+#include "catch.hpp"
+#include "maze_checks.hpp"
+#include "svg_export.hpp"
+#include "text_export.hpp"
+#include <cstdio>
+#include <optional>
+#include <string>
+
+namespace {
+// Runs `write` on a temporary file and returns what it wrote.
+template <typename Write>
+std::string captured(Write&& write) {
+    auto* file{std::tmpfile()};
+    write(file);
+    std::string text(static_cast<std::size_t>(std::ftell(file)), '\0');
+    std::rewind(file);
+    text.resize(std::fread(text.data(), 1, text.size(), file));
+    std::fclose(file);
+    return text;
+}
+
+// 3x3 backtracker mazes, the torus one opens walls across both seams.
+Maze small_maze(Wrap wrap) {
+    Maze maze(3, 3, 1, 1, wrap);
+    maze_checks::drain(maze.generate((wrap == Wrap::Torus) ? 1 : 3));
+    return maze;
+}
+
+std::string text(const Maze& maze, TextStyle style) {
+    std::optional<std::size_t> bytes;
+    auto written{captured([&](std::FILE* file) { bytes = TextExporter(maze.walls(), style).write(file); })};
+    CHECK(bytes == written.size());
+    return written;
+}
+
+std::string svg(const Maze& maze, std::size_t segments, std::size_t walls) {
+    std::optional<SvgSummary> summary;
+    auto written{captured([&](std::FILE* file) { summary = SvgExporter(maze.walls(), 10).write(file); })};
+    REQUIRE(summary);
+    CHECK(summary->bytes == written.size());
+    CHECK(summary->segments == segments);
+    CHECK(summary->walls == walls);
+    return written;
+}
+
+constexpr static auto SVG_START{R"(<svg xmlns="http://www.w3.org/2000/svg" width="32" height="32" )"
+                                R"(viewBox="-1 -1 32 32">)"
+                                "\n"
+                                R"(<path fill="none" stroke="black" stroke-width="1" stroke-linecap="square" d=")"};
+constexpr static auto SVG_END{"\"/>\n</svg>\n"};
+} // namespace
+
+TEST_CASE("text export draws the walls", "[export]") {
+    auto maze{small_maze(Wrap::None)};
+    CHECK(text(maze, TextStyle::Ascii) == "+--+--+--+\n"
+                                          "|  |     |\n"
+                                          "+  +  +  +\n"
+                                          "|  |  |  |\n"
+                                          "+  +--+  +\n"
+                                          "|        |\n"
+                                          "+--+--+--+\n");
+    CHECK(text(maze, TextStyle::Unicode) == "┌──┬─────┐\n"
+                                            "│  │     │\n"
+                                            "│  │  ╷  │\n"
+                                            "│  │  │  │\n"
+                                            "│  └──┘  │\n"
+                                            "│        │\n"
+                                            "└────────┘\n");
+}
+
+TEST_CASE("text export opens the border where a torus joins its edges", "[export]") {
+    auto maze{small_maze(Wrap::Torus)};
+    CHECK(text(maze, TextStyle::Ascii) == "+--+  +  +\n"
+                                          "|  |     |\n"
+                                          "+  +--+--+\n"
+                                          "|  |     |\n"
+                                          "+  +  +--+\n"
+                                          "   |  |   \n"
+                                          "+--+  +  +\n");
+    CHECK(text(maze, TextStyle::Unicode) == "┌──┐     ╷\n"
+                                            "│  │     │\n"
+                                            "│  ├─────┤\n"
+                                            "│  │     │\n"
+                                            "╵  │  ┌──┘\n"
+                                            "   │  │   \n"
+                                            "╶──┘  ╵   \n");
+}
+
+TEST_CASE("svg export merges the walls into segments", "[export]") {
+    CHECK(svg(small_maze(Wrap::None), 7, 16) ==
+          std::string(SVG_START) + "M0 0h30M10 20h10M0 30h30M10 0v20M20 10v10M0 0v30M30 0v30" + SVG_END);
+    CHECK(svg(small_maze(Wrap::Torus), 8, 13) ==
+          std::string(SVG_START) + "M0 0h10M10 10h20M20 20h10M0 30h10M0 0v20M30 0v20M10 0v30M20 20v10" + SVG_END);
+}
@@ -0,0 +1,252 @@
+#include "catch.hpp"
+#include "generators.hpp"
+#include "maze_checks.hpp"
+#include <utility>
+#include <vector>
+
+namespace {
+// A 20x12 ring around a hole with an island in the hole, which is cut off from the start and has to stay closed.
+BitPlane ring_mask() {
+    BitPlane mask(20, 12, false);
+    for (std::size_t row = 0; row < 12; ++row) {
+        for (std::size_t col = 0; col < 20; ++col) {
+            bool hole{col >= 4 && col < 16 && row >= 3 && row < 9};
+            bool island{col >= 7 && col < 13 && row >= 5 && row < 7};
+            if (!hole || island) {
+                mask.set(col, row);
+            }
+        }
+    }
+    return mask;
+}
+
+// Whether no wall is open to a cell outside the mask.
+bool inside_mask(const Maze& maze) {
+    for (std::size_t index = 0; index < maze.size(); ++index) {
+        for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+            if (!maze.has_wall(index, direction) &&
+                (!maze.is_allowed(index) || !maze.is_allowed(maze.neighbour_index(index, direction)))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Open walls across the seam of a cylinder or torus, which joins the last column to the first, and across the one of
+// a torus joining the last row to the first.
+std::pair<std::size_t, std::size_t> seam_passages(const Maze& maze) {
+    std::pair<std::size_t, std::size_t> open{0, 0};
+    for (std::size_t row = 0; row < maze.rows(); ++row) {
+        open.first += !maze.has_wall(row * maze.cols() + maze.cols() - 1, Direction::East);
+    }
+    for (std::size_t col = 0; col < maze.cols(); ++col) {
+        open.second += !maze.has_wall((maze.rows() - 1) * maze.cols() + col, Direction::South);
+    }
+    return open;
+}
+
+// Whether every event carves from a cell in the maze into a new one, starting from the start cell, until all cells
+// reachable from it are in.
+bool grows_from_start(const Maze& maze, Generator<MazeEvent> events) {
+    std::vector<bool> in_maze(maze.size(), false);
+    in_maze[maze.start()] = true;
+    std::size_t cells{1};
+    for (auto event : events) {
+        auto neighbour{maze.neighbour_index(event.index, event.direction)};
+        if (event.kind != MazeEvent::Kind::Carve || neighbour == Maze::NO_NEIGHBOUR || !in_maze[event.index] ||
+            in_maze[neighbour]) {
+            return false;
+        }
+        in_maze[neighbour] = true;
+        ++cells;
+    }
+    return cells == maze.reachable().count();
+}
+} // namespace
+
+TEST_CASE("masked mazes stay inside the mask", "[generators]") {
+    for (const auto& entry : generators::ENTRIES) {
+        for (uint64_t seed : {1, 2, 3}) {
+            INFO(entry.name << " seed " << seed);
+            Maze maze(ring_mask(), 1, 1);
+            auto events{generators::generate(maze, seed, entry.algorithm)};
+            CHECK(events.has_value() == entry.grows_from_start);
+            if (!events) {
+                continue;
+            }
+            maze_checks::drain(*events);
+            CHECK(inside_mask(maze));
+            CHECK(maze_checks::is_perfect(maze));
+            CHECK(maze_checks::passages(maze) == 20 * 12 - 12 * 6 - 1);
+        }
+    }
+}
+
+TEST_CASE("goals drawn from the reachable cells cover them in row order", "[generators]") {
+    Maze maze(ring_mask(), 1, 1);
+    auto reachable{maze.reachable()};
+    std::vector<std::size_t> cells;
+    for (std::size_t index = 0; index < maze.size(); ++index) {
+        if (reachable.test(index % maze.cols(), index / maze.cols())) {
+            cells.push_back(index);
+        }
+    }
+    REQUIRE(cells.size() == reachable.count());
+    std::vector<std::size_t> drawn;
+    for (std::size_t n = 0; n < reachable.count(); ++n) {
+        drawn.push_back(reachable.nth_set(n));
+    }
+    CHECK(drawn == cells);
+}
+
+TEST_CASE("nth set bit skips the padding of rows longer than a word", "[generators]") {
+    BitPlane plane(130, 3, false);
+    std::vector<std::size_t> cells{5, 63, 64, 129, 130 + 0, 130 + 128, 260 + 64, 260 + 129};
+    for (auto index : cells) {
+        plane.set(index % 130, index / 130);
+    }
+    std::vector<std::size_t> drawn;
+    for (std::size_t n = 0; n < plane.count(); ++n) {
+        drawn.push_back(plane.nth_set(n));
+    }
+    CHECK(drawn == cells);
+}
+
+TEST_CASE("wrapping mazes are perfect and pass through their seams", "[generators]") {
+    for (auto wrap : {Wrap::Cylinder, Wrap::Torus}) {
+        for (const auto& entry : generators::ENTRIES) {
+            INFO(entry.name << " wrap " << static_cast<int>(wrap));
+            // the row carvers and division cut the rectangle itself, only the generators walking from cell to cell
+            // see the joined edges
+            bool walks{entry.algorithm != Algorithm::BinaryTree && entry.algorithm != Algorithm::Sidewinder &&
+                       entry.algorithm != Algorithm::RecursiveDivision};
+            std::pair<std::size_t, std::size_t> seams{0, 0};
+            for (uint64_t seed : {1, 2, 3, 4}) {
+                Maze maze(16, 12, 1, 1, wrap);
+                maze_checks::drain(entry.events(maze, seed));
+                CHECK(maze_checks::is_perfect(maze));
+                auto [cols, rows] = seam_passages(maze);
+                seams.first += cols;
+                seams.second += rows;
+            }
+            if (walks) {
+                CHECK(seams.first > 0);
+                CHECK((seams.second > 0) == (wrap == Wrap::Torus));
+            } else {
+                CHECK(seams == std::pair<std::size_t, std::size_t>{0, 0});
+            }
+        }
+    }
+}
+
+TEST_CASE("row carvers give the same perfect maze on any number of threads", "[generators]") {
+    for (auto algorithm : {Algorithm::BinaryTree, Algorithm::Sidewinder}) {
+        for (auto [cols, rows] : {std::pair<std::size_t, std::size_t>{130, 40}, {5, 3}, {1, 9}}) {
+            for (uint64_t seed : {1, 2}) {
+                INFO(static_cast<int>(algorithm) << " " << cols << "x" << rows << " seed " << seed);
+                Maze maze(cols, rows, 1, 1);
+                maze_checks::drain(maze.generate_rows(seed, algorithm));
+                CHECK(maze_checks::is_perfect(maze));
+                for (std::size_t threads : {1, 2, 3, 8}) {
+                    Maze carved(cols, rows, 1, 1);
+                    carved.carve_rows(seed, algorithm, threads);
+                    CHECK(maze_checks::same_walls(carved, maze));
+                }
+
+                // binary tree opens north or east of every cell but the last of the first row, sidewinder opens the
+                // first row and north of exactly one cell of every run of cells joined east to west
+                for (std::size_t row = 0; row < rows; ++row) {
+                    std::size_t north_in_run{0};
+                    for (std::size_t col = 0; col < cols; ++col) {
+                        auto index{row * cols + col};
+                        bool north{!maze.has_wall(index, Direction::North)};
+                        bool east{!maze.has_wall(index, Direction::East)};
+                        if (row == 0) {
+                            CHECK(east == (col + 1 < cols));
+                        } else if (algorithm == Algorithm::BinaryTree) {
+                            CHECK(north + east == 1);
+                        } else {
+                            north_in_run += north;
+                            if (!east) {
+                                CHECK(north_in_run == 1);
+                                north_in_run = 0;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("recursive division gives the same perfect maze on any number of threads", "[generators]") {
+    // the larger maze splits into chambers big enough to be divided as tasks
+    for (auto [cols, rows] : {std::pair<std::size_t, std::size_t>{300, 200}, {7, 70}, {1, 1}}) {
+        for (uint64_t seed : {1, 2}) {
+            INFO(cols << "x" << rows << " seed " << seed);
+            Maze maze(cols, rows, 1, 1);
+            maze_checks::drain(maze.generate_divided(seed));
+            CHECK(maze_checks::is_perfect(maze));
+            for (std::size_t threads : {1, 2, 3, 8}) {
+                Maze divided(cols, rows, 1, 1);
+                divided.divide(seed, threads);
+                CHECK(maze_checks::same_walls(divided, maze));
+            }
+        }
+    }
+}
+
+TEST_CASE("hunt and kill carves every wall from the maze into a new cell", "[generators]") {
+    // more than a word of rows and of columns, so the hunt skips whole words of finished rows
+    for (auto wrap : {Wrap::None, Wrap::Cylinder, Wrap::Torus}) {
+        for (uint64_t seed : {1, 2, 3}) {
+            INFO("seed " << seed << " wrap " << static_cast<int>(wrap));
+            Maze maze(70, 130, 1, 1, wrap);
+            CHECK(grows_from_start(maze, maze.hunt_and_kill(seed)));
+            CHECK(maze_checks::is_perfect(maze));
+        }
+    }
+}
+
+TEST_CASE("prim grows a perfect maze from the frontier", "[generators]") {
+    for (auto wrap : {Wrap::None, Wrap::Torus}) {
+        for (uint64_t seed : {1, 2, 3}) {
+            INFO("seed " << seed << " wrap " << static_cast<int>(wrap));
+            Maze maze(70, 45, 1, 1, wrap);
+            CHECK(grows_from_start(maze, maze.prim(seed)));
+            CHECK(maze_checks::is_perfect(maze));
+            Maze again(70, 45, 1, 1, wrap);
+            maze_checks::drain(again.prim(seed));
+            CHECK(maze_checks::same_walls(again, maze));
+        }
+    }
+    Maze masked(ring_mask(), 1, 1);
+    CHECK(grows_from_start(masked, masked.prim(4)));
+    CHECK(maze_checks::is_perfect(masked));
+}
+
+TEST_CASE("every registered generator makes a perfect maze and carves the walls of its events", "[generators]") {
+    for (const auto& entry : generators::ENTRIES) {
+        CHECK(generators::find(entry.name) == &entry);
+        CHECK(&generators::find(entry.algorithm) == &entry);
+        for (uint64_t seed : {1, 2}) {
+            INFO(entry.name << " seed " << seed);
+            Maze maze(33, 21, 1, 1);
+            auto events{generators::generate(maze, seed, entry.algorithm)};
+            REQUIRE(events);
+            maze_checks::drain(*events);
+            CHECK(maze.algorithm() == entry.algorithm);
+            CHECK(maze.seed() == seed);
+            CHECK(maze_checks::is_perfect(maze));
+
+            Maze carved(33, 21, 1, 1);
+            CHECK(generators::carve(carved, seed, entry.algorithm, 3) == (entry.carve != nullptr));
+            if (entry.carve) {
+                CHECK(maze_checks::same_walls(carved, maze));
+            }
+        }
+    }
+    CHECK(generators::find("no-such-generator") == nullptr);
+    CHECK(&generators::find(Algorithm::Imported) == &generators::ENTRIES.front());
+}
@@ -0,0 +1,146 @@
+#include "catch.hpp"
+#include "grid_maze.hpp"
+#include "maze.hpp"
+#include "random.hpp"
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+// Steps from `start` to `goal` along the open sides, found breadth first.
+template <typename Topology>
+std::size_t distance(const GridMaze<Topology>& maze, std::size_t start, std::size_t goal) {
+    std::vector<std::size_t> steps(maze.size(), maze.size());
+    std::queue<std::size_t> queue;
+    steps[start] = 0;
+    queue.push(start);
+    while (!queue.empty()) {
+        auto current{queue.front()};
+        queue.pop();
+        for (std::size_t side = 0; side < Topology::SIDES; ++side) {
+            if (!maze.is_open(current, side)) {
+                continue;
+            }
+            auto neighbour{maze.neighbour_index(current, static_cast<uint8_t>(side))};
+            if (steps[neighbour] == maze.size()) {
+                steps[neighbour] = steps[current] + 1;
+                queue.push(neighbour);
+            }
+        }
+    }
+    return steps[goal];
+}
+
+// Cheapest sum of the costs of the cells entered from `start` to `goal`, found with a binary heap.
+int32_t dijkstra(const Maze& maze, std::size_t start, std::size_t goal) {
+    constexpr auto UNREACHED{std::numeric_limits<int32_t>::max()};
+    std::vector<int32_t> costs(maze.size(), UNREACHED);
+    using Entry = std::pair<int32_t, std::size_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+    costs[start] = 0;
+    queue.push({0, start});
+    while (!queue.empty()) {
+        auto [cost, current] = queue.top();
+        queue.pop();
+        if (cost > costs[current]) {
+            continue;
+        }
+        for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+            if (maze.has_wall(current, direction)) {
+                continue;
+            }
+            auto neighbour{maze.neighbour_index(current, direction)};
+            if (cost + maze.cost(neighbour) < costs[neighbour]) {
+                costs[neighbour] = cost + maze.cost(neighbour);
+                queue.push({costs[neighbour], neighbour});
+            }
+        }
+    }
+    return costs[goal];
+}
+
+template <typename Topology>
+void check_perfect_and_shortest(uint64_t seed) {
+    GridMaze<Topology> maze(23, 17);
+    for ([[maybe_unused]] auto& event : maze.generate(seed)) {
+    }
+    std::size_t open_sides{0};
+    for (std::size_t index = 0; index < maze.size(); ++index) {
+        for (std::size_t side = 0; side < Topology::SIDES; ++side) {
+            open_sides += maze.is_open(index, side);
+        }
+    }
+    // a spanning tree, every passage is open from both sides
+    CHECK(open_sides == 2 * (maze.size() - 1));
+
+    auto goal{maze.size() - 1};
+    std::size_t path{0};
+    for (auto& event : maze.solve(0, goal)) {
+        path += (event.kind == MazeEvent::Kind::Path);
+    }
+    CHECK(path == distance(maze, 0, goal));
+}
+} // namespace
+
+TEST_CASE("grid search generates the same square maze for Maze and GridMaze", "[grid_search]") {
+    for (uint64_t seed = 1; seed <= 5; ++seed) {
+        Maze maze(19, 13, 1, 1);
+        GridMaze<SquareTopology> grid(19, 13);
+        for ([[maybe_unused]] auto& event : maze.generate(seed)) {
+        }
+        for ([[maybe_unused]] auto& event : grid.generate(seed)) {
+        }
+        for (std::size_t index = 0; index < maze.size(); ++index) {
+            for (auto direction : {Direction::North, Direction::East, Direction::South, Direction::West}) {
+                CHECK(grid.is_open(index, std::to_underlying(direction)) == !maze.has_wall(index, direction));
+            }
+        }
+
+        std::size_t maze_path{0};
+        std::size_t grid_path{0};
+        for (auto& event : maze.solve(0, maze.size() - 1)) {
+            maze_path += (event.kind == MazeEvent::Kind::Path);
+        }
+        for (auto& event : grid.solve(0, grid.size() - 1)) {
+            grid_path += (event.kind == MazeEvent::Kind::Path);
+        }
+        CHECK(maze_path == grid_path);
+    }
+}
+
+TEST_CASE("grid search carves spanning trees and finds shortest paths on every topology", "[grid_search]") {
+    for (uint64_t seed = 1; seed <= 5; ++seed) {
+        check_perfect_and_shortest<SquareTopology>(seed);
+        check_perfect_and_shortest<HexTopology>(seed);
+        check_perfect_and_shortest<TriangleTopology>(seed);
+    }
+}
+
+TEST_CASE("grid search finds the cheapest path through braided mazes with costs", "[grid_search]") {
+    for (auto wrap : {Wrap::None, Wrap::Torus}) {
+        for (uint64_t seed = 1; seed <= 5; ++seed) {
+            INFO("seed " << seed << " wrap " << static_cast<int>(wrap));
+            Maze maze(37, 23, 1, 1, wrap);
+            for ([[maybe_unused]] auto& event : maze.generate(seed)) {
+            }
+            for ([[maybe_unused]] auto& event : maze.braid(1.0, seed)) {
+            }
+            Random random(seed);
+            std::vector<uint8_t> costs(maze.size());
+            for (auto& cost : costs) {
+                cost = static_cast<uint8_t>(1 + random.below((seed % 2 == 0) ? 16 : 255));
+            }
+            REQUIRE(maze.set_costs(std::move(costs)));
+
+            for (std::size_t pair = 0; pair < 8; ++pair) {
+                auto start{random.below(maze.size())};
+                auto goal{random.below(maze.size())};
+                for ([[maybe_unused]] auto& event : maze.solve(start, goal)) {
+                }
+                CHECK(maze.path_cost(goal) == dijkstra(maze, start, goal));
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#include "catch.hpp"
+#include "growing_tree.hpp"
+#include "maze_checks.hpp"
+#include "random.hpp"
+#include <vector>
+
+TEST_CASE("active set keeps the newest cell last and replaces others by the oldest", "[growing_tree]") {
+    growing_tree::ActiveSet active;
+    std::vector<std::size_t> model;
+    Random random(5);
+    for (std::size_t cell = 0; cell < 5000; ++cell) {
+        if (model.empty() || random.below(3) != 0) {
+            active.push(cell);
+            model.push_back(cell);
+            continue;
+        }
+        auto position{random.below(model.size())};
+        active.remove(position);
+        if (position + 1 == model.size()) {
+            model.pop_back();
+        } else {
+            model[position] = model.front();
+            model.erase(model.begin());
+        }
+        REQUIRE(active.size() == model.size());
+        bool same{true};
+        for (std::size_t i = 0; i < model.size(); ++i) {
+            same = same && active[i] == model[i];
+        }
+        REQUIRE(same);
+    }
+    active.clear();
+    CHECK(active.empty());
+}
+
+TEST_CASE("growing tree policies give perfect mazes of their own shape", "[growing_tree]") {
+    for (auto wrap : {Wrap::None, Wrap::Torus}) {
+        for (uint64_t seed : {1, 2, 3}) {
+            INFO("seed " << seed << " wrap " << static_cast<int>(wrap));
+            std::vector<std::size_t> dead_ends;
+            auto grow = [&](auto policy) {
+                Maze maze(60, 40, 1, 1, wrap);
+                maze_checks::drain(maze.grow<decltype(policy)>(seed));
+                CHECK(maze.algorithm() == decltype(policy)::ALGORITHM);
+                CHECK(maze_checks::is_perfect(maze));
+                dead_ends.push_back(maze.count_dead_ends());
+            };
+            grow(growing_tree::NewestCell{});
+            grow(growing_tree::MixedCell<50>{});
+            grow(growing_tree::RandomCell{});
+            // the newest cell makes long corridors with few dead ends, a random one short branches with many
+            CHECK(dead_ends[0] < dead_ends[1]);
+            CHECK(dead_ends[1] < dead_ends[2]);
+            grow(growing_tree::OldestCell{});
+        }
+    }
+}
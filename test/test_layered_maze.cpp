@@ -0,0 +1,78 @@
+#include "catch.hpp"
+#include "layered_maze.hpp"
+#include <filesystem>
+
+TEST_CASE("layered maze is a tree joined in several places between layers", "[layered_maze]") {
+    for (uint64_t seed = 1; seed <= 5; ++seed) {
+        LayeredMaze maze;
+        maze.generate(9, 7, 5, seed);
+        REQUIRE(maze.size() == 9 * 7 * 5);
+
+        std::size_t passages{0};
+        for (std::size_t z = 0; z < maze.layers(); ++z) {
+            std::size_t openings{0};
+            for (std::size_t row = 0; row < maze.rows(); ++row) {
+                for (std::size_t col = 0; col < maze.cols(); ++col) {
+                    passages += !maze.has_wall(col, row, z, Direction::East);
+                    passages += !maze.has_wall(col, row, z, Direction::South);
+                    openings += !maze.has_wall(col, row, z, Direction::Up);
+                }
+            }
+            if (z + 1 < maze.layers()) {
+                CHECK(openings > 1);
+            } else {
+                CHECK(openings == 0);
+            }
+            passages += openings;
+        }
+        // connected with one passage less than cells, so there is exactly one way between any two cells
+        CHECK(passages == maze.size() - 1);
+        for (std::size_t index = 0; index < maze.size(); ++index) {
+            CHECK(maze.distance(0, index));
+        }
+    }
+}
+
+TEST_CASE("layered maze file maps the layers it was saved with", "[layered_maze]") {
+    auto path{(std::filesystem::temp_directory_path() / "test_layered_maze.mz3").string()};
+    REQUIRE(save_layers(path, 70, 9, 4, 3));
+    LayeredMaze generated;
+    generated.generate(70, 9, 4, 3);
+    LayeredMaze mapped;
+    REQUIRE(mapped.open(path));
+    REQUIRE(mapped.layers() == 4);
+    for (std::size_t z = 0; z < 4; ++z) {
+        for (std::size_t row = 0; row < 9; ++row) {
+            for (std::size_t col = 0; col < 70; ++col) {
+                for (auto direction : {Direction::East, Direction::South, Direction::Up}) {
+                    CHECK(mapped.has_wall(col, row, z, direction) == generated.has_wall(col, row, z, direction));
+                }
+            }
+        }
+    }
+    mapped.close();
+
+    SECTION("a header whose file size wraps around is refused") {
+        // 128 columns take 2 words a row, so 178956970 rows are one word short of 2^33 bytes a layer, and 2^31
+        // layers of those wrap the file size around to the header page alone
+        layered_file::Header header{layered_file::MAGIC,
+                                    layered_file::VERSION,
+                                    0,
+                                    128,
+                                    178956970,
+                                    uint32_t{1} << 31,
+                                    0,
+                                    3,
+                                    2,
+                                    uint64_t{1} << 33,
+                                    maze_file::PAGE_SIZE};
+        std::string page(maze_file::PAGE_SIZE, '\0');
+        std::memcpy(page.data(), &header, sizeof(header));
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(page.data(), static_cast<std::streamsize>(page.size()));
+        file.close();
+        CHECK_FALSE(mapped.open(path));
+        CHECK_FALSE(layered_file::make_header(128, 178956970, uint32_t{1} << 31, 3));
+    }
+    std::filesystem::remove(path);
+}
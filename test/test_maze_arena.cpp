@@ -0,0 +1,83 @@
+#include "catch.hpp"
+#include "generators.hpp"
+#include "maze_arena.hpp"
+#include "maze_checks.hpp"
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+// Every allocation of the test binary goes through here, so the arena's can be counted.
+namespace {
+std::atomic<std::size_t> allocations{0};
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto* memory{std::malloc((size > 0) ? size : 1)}) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+constexpr static std::array<std::pair<std::size_t, std::size_t>, 4> SIZES{{{24, 24}, {9, 31}, {40, 5}, {2, 3}}};
+constexpr static std::array<Wrap, 3> WRAPS{Wrap::None, Wrap::Cylinder, Wrap::Torus};
+
+void generate_and_solve(MazeArena& arena, const generators::Entry& entry, std::size_t shape, Wrap wrap, uint64_t seed) {
+    auto [cols, rows] = SIZES[shape];
+    const auto& maze{arena.generate(cols, rows, seed, entry.algorithm, wrap)};
+    arena.solve(maze.size() - 1);
+}
+} // namespace
+
+TEST_CASE("maze arena allocates nothing once it has run every generator on its largest maze", "[maze_arena]") {
+    MazeArena arena(1, 1);
+    for (const auto& entry : generators::ENTRIES) {
+        for (std::size_t shape = 0; shape < SIZES.size(); ++shape) {
+            for (auto wrap : WRAPS) {
+                for (uint64_t seed = 0; seed < 4; ++seed) {
+                    generate_and_solve(arena, entry, shape, wrap, seed);
+                }
+            }
+        }
+    }
+
+    Random random(5);
+    auto before{allocations.load()};
+    for (std::size_t maze = 0; maze < 2000; ++maze) {
+        generate_and_solve(arena,
+                           generators::ENTRIES[random.below(generators::ENTRIES.size())],
+                           random.below(SIZES.size()),
+                           WRAPS[random.below(WRAPS.size())],
+                           random.next());
+    }
+    // read before the check, which allocates itself
+    auto allocated{allocations.load() - before};
+    CHECK(allocated == 0);
+}
+
+TEST_CASE("maze arena generates the same mazes as fresh ones", "[maze_arena]") {
+    MazeArena arena(1, 1);
+    for (const auto& entry : generators::ENTRIES) {
+        for (std::size_t shape = 0; shape < SIZES.size(); ++shape) {
+            auto [cols, rows] = SIZES[shape];
+            for (auto wrap : WRAPS) {
+                Maze fresh(cols, rows, 1, 1, wrap);
+                maze_checks::drain(*generators::generate(fresh, 9, entry.algorithm));
+                const auto& reused{arena.generate(cols, rows, 9, entry.algorithm, wrap)};
+                CHECK(maze_checks::same_walls(reused, fresh));
+                CHECK(maze_checks::is_perfect(reused));
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#include "catch.hpp"
+#include "maze_cache.hpp"
+#include "maze_checks.hpp"
+
+namespace {
+using maze_checks::same_walls;
+
+MazeDescriptor descriptor(uint64_t seed, Wrap wrap = Wrap::None) {
+    return {Algorithm::Backtracker, 16, 16, seed, wrap};
+}
+
+// Bytes a materialized 16x16 maze holds.
+std::size_t maze_bytes() {
+    return materialize(descriptor(0), 1, 1)->memory_usage();
+}
+} // namespace
+
+TEST_CASE("maze cache evicts the least recently used maze", "[maze_cache]") {
+    MazeCache cache(3 * maze_bytes(), 1, 1);
+    cache.get(descriptor(1));
+    cache.get(descriptor(2));
+    cache.get(descriptor(3));
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.evictions() == 0);
+
+    // using the first maze again leaves the second one as the least recently used
+    cache.get(descriptor(1));
+    cache.get(descriptor(4));
+    CHECK(cache.evictions() == 1);
+    CHECK(cache.contains(descriptor(1)));
+    CHECK_FALSE(cache.contains(descriptor(2)));
+    CHECK(cache.contains(descriptor(3)));
+    CHECK(cache.contains(descriptor(4)));
+    CHECK(cache.hits() == 1);
+    CHECK(cache.misses() == 4);
+}
+
+TEST_CASE("maze cache stays within its memory limit", "[maze_cache]") {
+    auto limit{5 * maze_bytes() / 2};
+    MazeCache cache(limit, 1, 1);
+    for (uint64_t seed = 0; seed < 10; ++seed) {
+        cache.get(descriptor(seed));
+        CHECK(cache.memory_usage() <= limit);
+    }
+    CHECK(cache.size() == 2);
+    CHECK(cache.evictions() == 8);
+
+    SECTION("the most recently used maze is kept even above the limit") {
+        MazeCache tiny(1, 1, 1);
+        auto maze{tiny.get(descriptor(1))};
+        CHECK(tiny.size() == 1);
+        CHECK(tiny.contains(descriptor(1)));
+    }
+}
+
+TEST_CASE("maze cache regenerates an evicted maze identically", "[maze_cache]") {
+    MazeCache cache(maze_bytes(), 1, 1);
+    auto first{cache.get(descriptor(7))};
+    cache.get(descriptor(8));
+    REQUIRE_FALSE(cache.contains(descriptor(7)));
+
+    auto again{cache.get(descriptor(7))};
+    CHECK(again != first);
+    CHECK(same_walls(*again, *first));
+    CHECK(describe(*again) == descriptor(7));
+}
+
+TEST_CASE("maze cache keeps mazes of different wraps apart", "[maze_cache]") {
+    MazeCache cache(16 * maze_bytes(), 1, 1);
+    auto flat{cache.get(descriptor(5))};
+    auto torus{cache.get(descriptor(5, Wrap::Torus))};
+    CHECK(cache.size() == 2);
+    CHECK(torus->wrap() == Wrap::Torus);
+    CHECK_FALSE(same_walls(*flat, *torus));
+    CHECK(describe(*torus) == descriptor(5, Wrap::Torus));
+}
+
+TEST_CASE("maze memory usage counts the neighbour lookups and the solver's open set", "[maze_cache]") {
+    // one long row, so the column lookups outweigh the planes
+    Maze maze(1000, 1, 1, 1, Wrap::Cylinder);
+    maze_checks::drain(maze.generate(1));
+    auto lookup_bytes{2 * (maze.cols() + maze.rows()) * sizeof(std::size_t)};
+    CHECK(maze.memory_usage() >= lookup_bytes);
+
+    auto before_solve{maze.memory_usage()};
+    maze_checks::drain(maze.solve(0, maze.size() - 1));
+    // the open set links every cell both ways, the scores take one per cell
+    CHECK(maze.memory_usage() - before_solve >= maze.size() * (2 * sizeof(std::size_t) + sizeof(int32_t)));
+}
@@ -0,0 +1,73 @@
+#include "catch.hpp"
+#include "maze_checks.hpp"
+#include "maze_file.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+std::string file_path() {
+    return (std::filesystem::temp_directory_path() / "test_maze_file.maze").string();
+}
+
+// Rewrites the saved file with `edit` applied to its bytes.
+template <typename Edit>
+void edit_file(const std::string& path, Edit&& edit) {
+    std::string bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    edit(bytes);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+} // namespace
+
+TEST_CASE("maze file maps the walls it was saved with", "[maze_file]") {
+    for (auto wrap : {Wrap::None, Wrap::Torus}) {
+        Maze maze(130, 21, 1, 1, wrap);
+        maze_checks::drain(maze.prim(4));
+        REQUIRE(save_maze(maze, file_path()));
+
+        MappedMaze mapped;
+        REQUIRE(mapped.open(file_path(), 1, 1));
+        CHECK(mapped.maze().is_read_only());
+        CHECK(mapped.maze().seed() == 4);
+        CHECK(mapped.maze().algorithm() == Algorithm::Prim);
+        CHECK(mapped.maze().wrap() == wrap);
+        CHECK(maze_checks::same_walls(mapped.maze(), maze));
+    }
+    std::filesystem::remove(file_path());
+}
+
+TEST_CASE("maze file refuses damaged files", "[maze_file]") {
+    Maze maze(70, 40, 1, 1);
+    maze_checks::drain(maze.generate(2));
+    REQUIRE(save_maze(maze, file_path()));
+    MappedMaze mapped;
+
+    SECTION("a file cut off within the south walls") {
+        edit_file(file_path(), [](std::string& bytes) { bytes.resize(bytes.size() - 8); });
+        CHECK_FALSE(mapped.open(file_path(), 1, 1));
+    }
+    SECTION("a file cut off within the header") {
+        edit_file(file_path(), [](std::string& bytes) { bytes.resize(sizeof(maze_file::Header) - 1); });
+        CHECK_FALSE(mapped.open(file_path(), 1, 1));
+    }
+    SECTION("an algorithm that doesn't exist") {
+        edit_file(file_path(), [](std::string& bytes) {
+            bytes[offsetof(maze_file::Header, algorithm)] = static_cast<char>(std::to_underlying(LAST_ALGORITHM) + 1);
+        });
+        CHECK_FALSE(mapped.open(file_path(), 1, 1));
+    }
+    SECTION("a south plane whose end wraps around") {
+        edit_file(file_path(), [](std::string& bytes) {
+            uint64_t offset{~maze_file::PAGE_SIZE + 1};
+            std::memcpy(bytes.data() + offsetof(maze_file::Header, south_offset), &offset, sizeof(offset));
+        });
+        CHECK_FALSE(mapped.open(file_path(), 1, 1));
+    }
+    std::filesystem::remove(file_path());
+}
@@ -0,0 +1,104 @@
+#include "catch.hpp"
+#include "maze_checks.hpp"
+#include "png_import.hpp"
+#include <filesystem>
+#include <png.h>
+#include <string>
+#include <vector>
+
+namespace {
+std::string file_path() {
+    return (std::filesystem::temp_directory_path() / "test_png_import.png").string();
+}
+
+bool write_gray(const std::vector<png_byte>& pixels, uint32_t width, uint32_t height) {
+    png_image image{};
+    image.version = PNG_IMAGE_VERSION;
+    image.width = width;
+    image.height = height;
+    image.format = PNG_FORMAT_GRAY;
+    return png_image_write_to_file(&image, file_path().c_str(), 0, pixels.data(), 0, nullptr) != 0;
+}
+
+// Draws the walls black on white with square cells of `pitch` pixels, the way the importer reads them.
+std::vector<png_byte> draw(const WallGrid& walls, uint32_t pitch) {
+    auto width{walls.cols() * pitch + 1};
+    auto height{walls.rows() * pitch + 1};
+    std::vector<png_byte> pixels(width * height, 255);
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            auto col{x / pitch};
+            auto row{y / pitch};
+            bool on_column_line{x % pitch == 0};
+            bool on_row_line{y % pitch == 0};
+            bool wall{on_column_line && on_row_line};
+            if (on_column_line && !on_row_line) {
+                wall = col == 0 || col == walls.cols() || walls.has_wall(col - 1, row, Direction::East);
+            } else if (on_row_line && !on_column_line) {
+                wall = row == 0 || row == walls.rows() || walls.has_wall(col, row - 1, Direction::South);
+            }
+            if (wall) {
+                pixels[y * width + x] = 0;
+            }
+        }
+    }
+    return pixels;
+}
+} // namespace
+
+TEST_CASE("png import reads the walls of a drawn maze", "[png_import]") {
+    Maze maze(23, 17, 1, 1);
+    maze_checks::drain(maze.generate(8));
+    for (uint32_t pitch : {2U, 5U}) {
+        REQUIRE(write_gray(draw(maze.walls(), pitch), 23 * pitch + 1, 17 * pitch + 1));
+        PngImporter importer;
+        REQUIRE(importer.open(file_path()));
+        auto walls{importer.walls(pitch)};
+        REQUIRE(walls);
+        Maze imported(std::move(*walls), 1, 1, 8, maze.algorithm(), Wrap::None);
+        CHECK(maze_checks::same_walls(imported, maze));
+    }
+    std::filesystem::remove(file_path());
+}
+
+TEST_CASE("png import refuses images that don't fit", "[png_import]") {
+    Maze maze(6, 4, 1, 1);
+    maze_checks::drain(maze.generate(8));
+    auto pixels{draw(maze.walls(), 4)};
+    PngImporter importer;
+
+    SECTION("a pitch that doesn't divide the image") {
+        REQUIRE(write_gray(pixels, 25, 17));
+        REQUIRE(importer.open(file_path()));
+        CHECK_FALSE(importer.walls(3));
+    }
+    SECTION("a gap in the border") {
+        pixels[2] = 255;
+        REQUIRE(write_gray(pixels, 25, 17));
+        REQUIRE(importer.open(file_path()));
+        CHECK_FALSE(importer.walls(4));
+    }
+    std::filesystem::remove(file_path());
+}
+
+TEST_CASE("png import reads masks and costs one cell per pixel", "[png_import]") {
+    std::vector<png_byte> pixels{0, 255, 127, 128, 16, 31, 200, 240};
+    REQUIRE(write_gray(pixels, 4, 2));
+    PngImporter importer;
+
+    REQUIRE(importer.open(file_path()));
+    auto mask{importer.mask()};
+    REQUIRE(mask);
+    CHECK(mask->count() == 4);
+    CHECK((mask->test(0, 0) && mask->test(2, 0) && mask->test(0, 1) && mask->test(1, 1)));
+
+    REQUIRE(importer.open(file_path()));
+    CHECK_FALSE(importer.costs(2, 4));
+    REQUIRE(importer.open(file_path()));
+    CHECK(importer.costs(4, 2) == std::vector<uint8_t>{1, 16, 8, 9, 2, 2, 13, 16});
+
+    REQUIRE(write_gray(std::vector<png_byte>(8, 255), 4, 2));
+    REQUIRE(importer.open(file_path()));
+    CHECK_FALSE(importer.mask());
+    std::filesystem::remove(file_path());
+}
@@ -0,0 +1,51 @@
+#include "catch.hpp"
+#include "maze_checks.hpp"
+
+using maze_checks::drain;
+using maze_checks::is_perfect;
+using maze_checks::same_walls;
+
+TEST_CASE("wilson carves the same perfect maze on any number of threads", "[wilson]") {
+    for (auto wrap : {Wrap::None, Wrap::Cylinder, Wrap::Torus}) {
+        for (uint64_t seed = 1; seed <= 3; ++seed) {
+            Maze single(37, 29, 1, 1, wrap);
+            single.wilson(seed, 1);
+            CHECK(is_perfect(single));
+            for (std::size_t threads : {2, 4, 8}) {
+                Maze parallel(37, 29, 1, 1, wrap);
+                parallel.wilson(seed, threads);
+                CHECK(same_walls(parallel, single));
+            }
+
+            // the events carve the walls of the walkers
+            Maze replayed(37, 29, 1, 1, wrap);
+            drain(replayed.generate_wilson(seed));
+            CHECK(same_walls(replayed, single));
+        }
+    }
+}
+
+TEST_CASE("wilson leaves grids without cells alone", "[wilson]") {
+    WallGrid walls(0, 0);
+    wilson::State state;
+    wilson::carve(walls, {0, 0, false, false}, 0, 1, 4, state);
+    CHECK(walls.cols() == 0);
+}
+
+TEST_CASE("aldous-broder walks within the part of a mask connected to the start", "[aldous_broder]") {
+    // two blocks of cells split by a column outside the mask
+    BitPlane mask(12, 8, true);
+    for (std::size_t row = 0; row < 8; ++row) {
+        mask.reset(5, row);
+    }
+    for (uint64_t seed = 1; seed <= 5; ++seed) {
+        Maze maze(mask, 1, 1);
+        drain(maze.aldous_broder(seed));
+        CHECK(is_perfect(maze));
+        CHECK(maze_checks::passages(maze) == 5 * 8 - 1);
+    }
+
+    Maze full(12, 8, 1, 1, Wrap::Torus);
+    drain(full.aldous_broder(7));
+    CHECK(is_perfect(full));
+}